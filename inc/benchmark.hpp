@@ -0,0 +1,35 @@
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+#include <checkers.hpp>
+#include <cstdint>
+#include <string>
+
+namespace Checkers {
+
+    // Benchmark class definition
+    class Benchmark {
+        public:
+            // time for the search to reach a fixed depth with 1, 2, 4, 8 and 16 threads
+            static void reportThreadScaling(int);
+
+            // leaf counts of the move generator to a fixed depth from each position of a perft file,
+            // checked against the file's reference counts (file, depth, threads, hash size in megabytes)
+            static bool runPerft(std::string const&, int, unsigned int, unsigned int);
+
+            // single-threaded search of the bench positions to a fixed depth; returns the node count signature
+            static uint64_t runBench(int);
+
+            // batch evaluation of the children of every node in the trees of the bench positions to a fixed
+            // depth, by each supported kernel for both players; returns false if any score differs from evaluateBoard
+            static bool runEvaluation(int);
+
+            // the move generator and the move tests (hasMove, hasCapture, mobility) against a plain reference
+            // generator, and making moves in place against building the next board, on every node in the trees
+            // of the bench positions to a fixed depth; returns false if anything differs
+            static bool runMoveCheck(int);
+    };
+
+}
+
+#endif
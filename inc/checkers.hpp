@@ -1,8 +1,13 @@
 #ifndef __CHECKERS_HPP__
 #define __CHECKERS_HPP__
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace Checkers {
@@ -13,7 +18,14 @@ namespace Checkers {
     extern unsigned int timeLimitLower;
     extern unsigned int timeLimitUpper;
     extern unsigned int moveLimit;
+    extern unsigned int repetitionLimit;
     extern double timeRemainingThreshold;
+    extern unsigned int timeCheckInterval;
+    extern unsigned int movesToGo;
+    extern unsigned int transpositionTableSize;
+    extern unsigned int searchThreads;
+    extern std::string tablebaseFilePath;
+    extern std::string openingBookFilePath;
 
 
     // timing type definitions
@@ -22,27 +34,300 @@ namespace Checkers {
     typedef std::chrono::steady_clock::time_point Time;
 
 
-    // Piece type definition
-    typedef struct {
-        bool isKing;
-        uint8_t xPos;
-        uint8_t yPos;
-    } Piece;
-
-
     // Board type definition
+    //   the 32 dark squares are numbered (4 * y + x / 2), so bit n of a mask is square n;
+    //   pieces[i] holds every piece of player i, and kings marks which of those are kings
     typedef struct {
-        uint8_t squares[8][8];
-        Piece pieces[2][12];
+        uint32_t pieces[2];
+        uint32_t kings;
     } Board;
 
 
     // Move type definition
+    //   the jumped squares are kept as a mask, so a move (even a multi-jump) is made in one step;
+    //   from and to are both 0xFF for the "no move" of a player who cannot move or forfeits
+    typedef struct {
+        uint32_t captures;
+        uint8_t from;
+        uint8_t to;
+        uint8_t player;
+    } Move;
+
+
+    // MovePath type definition (the squares a move passes through, for printing)
     typedef struct {
         uint8_t player;
         uint8_t xPath[13];
         uint8_t yPath[13];
-    } Move;
+    } MovePath;
+
+
+    // MoveList type definition (fixed capacity, so generating moves needs no heap allocation)
+    //   a position has at most 48 simple moves (12 pieces with 4 steps each); there is no such simple
+    //   bound on jump moves, so the move generator aborts rather than drop one if they do not fit (the
+    //   most in the trees of the perft and match opening positions is 6)
+    const unsigned int maxMoves = 128;
+    typedef struct {
+        Move moves[maxMoves];
+        uint8_t size;
+    } MoveList;
+
+
+    // EvaluationBlock type definition
+    //   boards laid out as a struct of arrays (each field of every board together), so a batch
+    //   evaluation loads the same field of several boards into one vector register
+    typedef struct {
+        uint32_t pieces[2][maxMoves];
+        uint32_t kings[maxMoves];
+        int32_t pieceSquareScores[maxMoves]; // piece-square score of each board
+        uint8_t size;
+    } EvaluationBlock;
+
+
+    // batch evaluation kernels
+    enum EvaluationKernel : uint8_t {
+          scalarKernel // evaluateBoard on each board
+        , sse2Kernel   // 4 boards at once
+        , avx2Kernel   // 8 boards at once
+    };
+
+
+    // record of a move made in place on a board, so the move can be taken back
+    typedef struct {
+        uint8_t player;
+        uint8_t from;           // square the moving piece started on
+        uint8_t to;             // square the moving piece ended on
+        bool wasKing;
+        bool promoted;
+        uint32_t captured;      // squares of the captured pieces
+        uint32_t capturedKings; // which of the captured pieces were kings
+    } MoveUndo;
+
+
+    // transposition table bound types
+    enum Bound : uint8_t {
+          exactBound // the score is the exact value of the position
+        , lowerBound // the search failed high; the value is at least the score
+        , upperBound // the search failed low; the value is at most the score
+    };
+
+
+    // transposition table entry type definition (as returned by a probe)
+    typedef struct {
+        uint64_t key;
+        int32_t score;
+        uint8_t depth;      // remaining search depth below the position
+        uint8_t bound;
+        uint8_t moveIndex;  // index of the best move in the generated move list
+        uint8_t generation; // search which stored the entry
+    } TableEntry;
+
+
+    // TranspositionTable class definition
+    class TranspositionTable {
+        public:
+            TranspositionTable();
+
+            // table size control (in megabytes)
+            void resize(unsigned int);
+            void clear();
+
+            // start a new search, aging the entries of the previous ones
+            void newSearch();
+
+            // entry operations (safe to use from several search threads at once)
+            bool probe(uint64_t, TableEntry&);
+            void store(uint64_t, uint8_t, uint8_t, int, uint8_t);
+        private:
+            // an entry packed into two words; check is the key xor the data, so a slot torn
+            // by simultaneous writes from two threads fails verification instead of being used
+            typedef struct {
+                uint64_t check;
+                uint64_t data;
+            } Slot;
+
+            std::vector<Slot> slots;
+            uint64_t mask;
+            uint8_t generation;
+    };
+
+
+    // endgame tablebase results for the player to move (the values are the codes in the tablebase file)
+    enum TablebaseResult : uint8_t {
+          tablebaseDraw
+        , tablebaseWin
+        , tablebaseLoss
+        , tablebaseUnknown // the position is not in the tablebase
+    };
+
+
+    // Tablebase class definition
+    //   the result of every position with up to a given number of pieces, worked out offline by
+    //   retrograde analysis and probed from a memory-mapped file
+    class Tablebase {
+        public:
+            Tablebase();
+
+            // offline generation (file path, number of pieces, number of threads)
+            static bool generate(std::string const&, int, unsigned int);
+
+            // tablebase file control
+            bool open(std::string const&);
+            void close();
+            int getMaxPieces();
+
+            // result of a board for the given player to move
+            TablebaseResult probe(Board const&, unsigned short);
+        private:
+            std::shared_ptr<const uint8_t> mapping; // the mapped file, unmapped once no copy uses it
+            const uint64_t * offsets;               // file offset of each material class (0 if absent)
+            int maxPieces;
+    };
+
+
+    // opening book entry type definition (as stored in the book file, sorted by key then move)
+    typedef struct {
+        uint64_t key;      // Zobrist key of the position and the player to move
+        uint32_t captures; // the move played
+        uint8_t from;
+        uint8_t to;
+        uint16_t weight;   // number of self-play games which played the move
+    } BookEntry;
+
+
+    // OpeningBook class definition
+    //   moves played by the computer in self-play games from the start position, looked up by
+    //   binary search in a memory-mapped file
+    class OpeningBook {
+        public:
+            OpeningBook();
+
+            // offline generation (file path, number of games, search depth, book plies, number of threads)
+            static bool generate(std::string const&, unsigned int, int, int, unsigned int);
+
+            // book file control
+            bool open(std::string const&);
+            void close();
+
+            // pick one of the book moves of a board for the given player to move (weighted by game count)
+            bool probe(Board const&, unsigned short, Move&);
+        private:
+            std::shared_ptr<const uint8_t> mapping; // the mapped file, unmapped once no copy uses it
+            const BookEntry * entries;
+            uint64_t numEntries;
+    };
+
+
+    // search of the position after the opponent's expected reply, run while the opponent thinks
+    typedef struct {
+        std::thread thread;
+        std::atomic<bool> active;  // no time limit applies until the opponent has moved
+        std::atomic<bool> abort;   // the opponent played another move
+        Board board;               // board after the expected reply
+        Move move;                 // move found by the search
+        int maxDepthReached;       // and its deepest finished iteration (copied into the player once joined)
+    } PonderSearch;
+
+
+    // statistics of one iteration of the search (the aspiration re-searches included); the last
+    // iteration of a search which ran out of time is unfinished
+    typedef struct {
+        int depth;
+        bool finished;
+        uint64_t nodes;
+        uint64_t evaluations;      // leaves scored by the evaluation (not the table, tablebase or a repetition)
+        uint64_t expandedNodes;    // nodes whose moves were searched
+        uint64_t cutoffs;          // expanded nodes cut off before all of their moves were searched
+        uint64_t firstMoveCutoffs; // of which by the first move searched
+        uint64_t tableProbes;
+        uint64_t tableHits;
+        double seconds;
+    } IterationStatistics;
+
+
+    // statistics of a search, counted by its main thread (but the total node count)
+    typedef struct {
+        std::string position;
+        Move move;
+        int depth;                           // deepest finished iteration
+        int score;
+        uint64_t nodes;
+        double seconds;
+        std::vector<IterationStatistics> iterations;
+        std::vector<uint64_t> plyNodes;      // nodes at each ply from the root
+        std::vector<uint64_t> plyEvaluations;
+    } SearchStatistics;
+
+
+    // state of one thread of the alpha-beta search
+    typedef struct {
+        uint8_t index;              // 0 is the main thread, which reports the move
+        std::atomic<bool> * stop;   // set once the main thread has finished
+        PonderSearch * ponder;      // the ponder search this thread is part of (null for a normal search)
+        int history[32][32];        // cutoff scores indexed by from and to square
+        uint16_t killers[50][2];    // most recent cutoff moves at each depth
+        uint64_t nodes;
+        uint64_t quiescenceNodes;   // the nodes past the full-width depth, playing out captures
+        int maxDepthReached;
+        Move bestMove;              // best move of the deepest finished iteration
+        int score;                  // and its score
+        uint64_t plyNodes[50];      // statistics: nodes and evaluations at each ply, and of each iteration
+        uint64_t plyEvaluations[50];
+        IterationStatistics iteration;
+        std::vector<IterationStatistics> iterations;
+    } SearchThread;
+
+
+    // progress of a search, reported after every finished iteration
+    typedef struct {
+        int depth;
+        int score;                           // from the view of the player to move
+        uint64_t nodes;
+        double seconds;
+        std::vector<Move> principalVariation;
+    } SearchInfo;
+
+
+    // limits of a search (whichever comes first ends it)
+    typedef struct {
+        double timeLimit;   // in seconds
+        uint64_t nodeLimit; // nodes of each search thread (0 for no limit)
+        int depthLimit;
+        unsigned int threads; // search threads (0 for Checkers::searchThreads)
+    } SearchLimits;
+
+
+    // result of a search: the move ("no move" if there is none), and its deepest finished iteration
+    typedef struct {
+        Move move;
+        SearchInfo info;
+    } SearchResult;
+
+
+    // TimeManager class definition
+    //   how long a search may go on; it is stopped at the hard limit, and starts no iteration past the
+    //   soft limit, or which it does not expect to finish before the hard limit
+    class TimeManager {
+        public:
+            TimeManager();
+
+            // time control: a fixed time per move, or the time left on the clock and the increment per move
+            void setMoveTime(double);
+            void setGameTime(double, double);
+
+            // work out the limits of the next move from the time control
+            void allocateMoveTime();
+            double getHardLimit();
+
+            // whether another iteration can start (seconds into the move, seconds of the last two iterations)
+            bool canStartIteration(double, double, double);
+        private:
+            double moveTime;
+            double gameTimeRemaining; // negative without a game clock
+            double gameTimeIncrement;
+            double softLimit;
+            double hardLimit;
+    };
 
 
     // Game forward declaration required by Player
@@ -54,13 +339,33 @@ namespace Checkers {
 		public:
             Player();
 			Player(Game *, bool, double);
+            Player(Game *, bool, double, bool); // a computer player without the tablebase and book files if false
 
             // determine a move for a given board
 			Move makeMove(Board const&);
             
             // computer board operations
-            Move pickMoveFromBoard(Board const&);
+            Move pickMoveFromBoard(Board const&); // for the game's player to move, on the game's clock
             int evaluateBoard(Board const&);
+            int evaluateBoard(Board const&, int); // with the board's piece-square score
+            void setSearchPlayer(uint8_t);         // player the evaluation scores for (set by each search)
+
+            // evaluation of every board of a block, each scored as evaluateBoard would, into an array of
+            // scores; the widest kernel the processor supports is used, unless another one is given
+            void evaluateBlock(EvaluationBlock const&, int *);
+            void evaluateBlock(EvaluationBlock const&, int *, EvaluationKernel);
+            static bool isEvaluationKernelSupported(EvaluationKernel);
+
+            // search of any board for the given player to move, within the given limits (which stay set
+            // for later searches); it reads no game, so players made without one (Player(nullptr, true, 0))
+            // can each search on their own boards at the same time
+            SearchResult search(Board const&, uint8_t, SearchLimits const&);
+            SearchResult search(Board const&, uint8_t, SearchLimits const&, std::vector<uint64_t> const&); // with the game's key history
+
+            // piece-square score (material and the terms depending only on where each piece stands),
+            // as Player 1's total minus Player 2's; the search updates it with each move
+            static int getPieceSquareScoreFromBoard(Board const&);
+            static int getNextPieceSquareScoreFromMoveUndo(int, MoveUndo const&);
 
             // add made moves to a move list
             void addMadeMove(Move const&);
@@ -73,18 +378,75 @@ namespace Checkers {
 
             // alpha-beta functions
             int getMaxDepthReached();
+            uint64_t getNodeCount();
+            uint64_t getQuiescenceNodeCount();
+            void setDepthLimit(int);
+            void setNodeLimit(uint64_t);
+            void setThreadCount(unsigned int); // search threads of this player (Checkers::searchThreads by default)
+            void setTimeLimit(double);
+            void setGameTime(double, double); // the clock instead of the time limit (remaining, increment)
+
+            // control of a search running on another thread
+            void stopSearch();
+            void clearStopRequest();
+            void setInfoCallback(std::function<void(SearchInfo const&)> const&);
+
+            // statistics of every search (the callback is called from the searching thread), and their
+            // JSON record, on a single line
+            void setStatisticsCallback(std::function<void(SearchStatistics const&)> const&);
+            static std::string getJsonFromStatistics(SearchStatistics const&);
+
+            // searching the expected reply on the opponent's time, after each move (off by default)
+            void setPonder(bool);
+            void stopPondering();
 		private:
             // for access to the game instance
             Game * game;
 
+            // positions seen by the alpha-beta search (shared by all of its threads)
+            TranspositionTable table;
+            std::shared_ptr<std::atomic<bool> > stopRequest; // set to end the search early
+            std::function<void(SearchInfo const&)> infoCallback;
+            std::function<void(SearchStatistics const&)> statisticsCallback;
+            Tablebase tablebase;
+            OpeningBook book;
+            std::vector<SearchThread> threads;
+            uint8_t searchPlayer; // player to move at the root of the search
+            Time searchStartTime; // start of its clock (for a ponder search, set once the expected reply is played)
+            std::vector<uint64_t> keyHistory; // of the game up to the root of the search, for repetitions
+            bool ponder;
+            std::shared_ptr<PonderSearch> ponderSearch; // null while not pondering
+
 			std::vector<Move> moveList;
 
-            double timeLimit;
+            TimeManager timeManager;
 			Duration totalMoveTime;
             Duration previousMoveTime;
 
 			bool isComputer;
             int maxDepthReached;
+            int depthLimit;
+            uint64_t nodeLimit; // nodes of each search thread per move (0 for no limit)
+            unsigned int threadCount;
+
+            // Lazy SMP search of a board for a player, from searchStartTime
+            Move pickMoveFromBoard_andPlayer(Board const&, uint8_t);
+
+            // start the search of the expected reply to a move made on a board
+            void startPondering(Board const&, Move const&);
+
+            // alpha-beta search run by every search thread
+            void searchFromBoard(Board const&, SearchThread&);
+
+            // move ordering for the alpha-beta search
+            void orderMoves(MoveList const&, uint8_t *, uint8_t, uint8_t, SearchThread&);
+            void addCutoffMove(Move const&, uint8_t, uint8_t, SearchThread&);
+
+            // score of a position with a tablebase result (result, player to move, piece-square score)
+            int getScoreFromTablebaseResult(TablebaseResult, uint8_t, int);
+
+            // best line found by the last search, following the table from its best move
+            std::vector<Move> getPrincipalVariation(Board const&, Move const&, int);
 	};
 
 
@@ -93,10 +455,15 @@ namespace Checkers {
             Game();
 
             // general game control operations
-            void start(bool, bool, unsigned short, double);
+            void start(bool, bool, unsigned short, double, bool);
+            int play(Player const&, Player const&, unsigned short);
             void stop();
             void reset();
 
+            // file the computer players of start write the statistics of every search to, one JSON record
+            // per line (none if empty)
+            void setLogFilePath(std::string const&);
+
             // game state load/save functionality
             void load(std::string const&);
             void save(std::string const&);
@@ -106,14 +473,39 @@ namespace Checkers {
             void setCurrentBoard(Board const&);
 
             // functional board and move utility functions
+            static Board getStartBoard();
             Board getNextBoardFromMove(Move const&); // uses the current board
-            Board getNextBoardFromMove_andBoard(Move const&, Board const&);
+            static Board getNextBoardFromMove_andBoard(Move const&, Board const&);
+            static void makeMoveOnBoard(Move const&, Board&, MoveUndo&);
+            static void unmakeMoveOnBoard(MoveUndo const&, Board&);
             static std::vector<Move> getMovesFromBoard_andPlayer(Board const&, unsigned short);
+            static void getMovesFromBoard_andPlayer(Board const&, unsigned short, MoveList&);
+            static bool hasCaptureFromBoard_andPlayer(Board const&, unsigned short);
+            static bool hasMoveFromBoard_andPlayer(Board const&, unsigned short);
+            static int getMobilityFromBoard_andPlayer(Board const&, unsigned short);
+            static uint64_t getKeyFromBoard_andPlayer(Board const&, unsigned short);
+            static uint64_t getNextKeyFromMoveUndo(uint64_t, MoveUndo const&);
+            static uint8_t getSquareFromBoard(Board const&, uint8_t, uint8_t);
+            static void setSquareOnBoard(Board&, uint8_t, uint8_t, uint8_t);
+            static MovePath getPathFromMove(Move const&);
             static std::string parseMove(Move const&);
 
-            // misc. game state getters
+            // position strings: the 32 squares in order (A1, C1, ..., H8) then the player to move,
+            // e.g. "************--------oooooooooooo 1" for the start position with Player 1 to move
+            static std::string getStringFromBoard_andPlayer(Board const&, unsigned short);
+            static bool getBoardFromString(std::string const&, Board&, unsigned short&);
+
+            // misc. game state getters and setters
             uint8_t getPlayerTurn();
+            void setPlayerTurn(uint8_t);
             Time getMoveStartTime();
+            void setMoveStartTime(Time const&);
+
+            // keys of the positions since the last capture or regular piece move (which cannot be undone),
+            // the current one last; a position reached repetitionLimit times draws the game
+            std::vector<uint64_t> const& getKeyHistory();
+            void setKeyHistory(std::vector<uint64_t> const&);
+            static void addMoveToKeyHistory(std::vector<uint64_t>&, Board const&, Move const&); // move made on the board
 
             // printing functions
             void printCurrentBoard();
@@ -128,6 +520,8 @@ namespace Checkers {
             unsigned int moveCount;
             unsigned int numMovesSinceCapture;
             std::vector<Move> moveList;
+            std::vector<uint64_t> keyHistory;
+            std::string logFilePath;
 
             Time moveStartTime;
             Duration previousMoveTime;
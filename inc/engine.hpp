@@ -0,0 +1,63 @@
+#ifndef __ENGINE_HPP__
+#define __ENGINE_HPP__
+
+#include <checkers.hpp>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace Checkers {
+
+    // Engine class definition
+    //   a line-based text protocol over standard input and output, for driving the computer from
+    //   another program; the commands are
+    //     newgame                                   forget the table and history of the last game
+    //     position start|<position> [moves <move> ...]
+    //     time <remaining ms> [<increment ms>]      the clock of the player to move
+    //     go [depth <n>] [nodes <n>] [movetime <ms>] [infinite]
+    //     log [<file>]                              write the statistics of every search to the file, one
+    //                                               JSON record per line (without a file, stop logging)
+    //     stop, isready, quit
+    //   and the replies are "readyok", "info depth <n> score <n>|win|loss nodes <n> nps <n> pv <move> ...",
+    //   and "bestmove <move>|none"; moves are their squares joined by '-' for a simple move or 'x' for
+    //   a jump (e.g. c3-d4 or a3xc5xe7), and positions are as in Game::getBoardFromString
+    class Engine {
+        public:
+            Engine();
+
+            // read commands until "quit" or the end of the input
+            void run(std::istream&, std::ostream&);
+        private:
+            Game game;
+            Player player;
+            Board board;
+            unsigned short playerTurn;
+
+            double timeRemaining; // on the clock of the player to move, in seconds (negative if not set)
+            double timeIncrement;
+
+            std::thread searchThread;
+            std::ostream * output;
+            std::mutex outputMutex; // info lines come from the search thread
+            std::ofstream log;      // only opened or closed while no search runs
+
+            // command handlers
+            void newGame();
+            bool setPosition(std::istringstream&);
+            void startSearch(std::istringstream&);
+            void stopSearch();
+            bool openLog(std::istringstream&);
+
+            void send(std::string const&);
+
+            // move notation of the protocol
+            static std::string getTextFromMove(Move const&);
+            static bool getMoveFromText(std::string const&, Board const&, unsigned short, Move&);
+    };
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __MATCH_HPP__
+#define __MATCH_HPP__
+
+#include <checkers.hpp>
+#include <cstdint>
+#include <string>
+
+namespace Checkers {
+
+    // settings of one engine of a match
+    typedef struct {
+        double timeLimit;   // seconds per move
+        uint64_t nodeLimit; // nodes per move (0 for no limit)
+        int depthLimit;
+        bool ponder;        // search on the opponent's time (on a thread of its own)
+    } EngineSettings;
+
+
+    // match settings
+    typedef struct {
+        std::string openingsFilePath;
+        std::string logFilePath; // JSON record of the statistics of every search, one per line (none if empty)
+        unsigned int games;
+        unsigned int threads;
+        EngineSettings engines[2];
+        double elo0;  // the sequential probability ratio test decides between an Elo difference
+        double elo1;  // (of the first engine over the second) of elo0 and one of elo1
+        double alpha; // chance of accepting elo1 when elo0 holds
+        double beta;  // chance of accepting elo0 when elo1 holds
+    } MatchSettings;
+
+
+    // Match class definition
+    class Match {
+        public:
+            static MatchSettings getDefaultSettings();
+
+            // set a setting from a "name=value" argument; false if there is no such setting
+            static bool setSetting(MatchSettings&, std::string const&);
+
+            // play the match on a pool of threads, each game from an opening of the openings file,
+            // and every opening once with each engine to move; false if no openings were read
+            static bool run(MatchSettings const&);
+    };
+
+}
+
+#endif
@@ -0,0 +1,711 @@
+#include <algorithm>
+#include <atomic>
+#include <benchmark.hpp>
+#include <checkers.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+
+///////////////////////////////////////////
+// BEGIN  Benchmark position definitions //
+///////////////////////////////////////////
+static const char * scalingPositions[] = {
+      "************--------oooooooooooo 1" // start position
+    , "*****-**--*-**-----o-o-ooooooo-o 1" // opening
+    , "**-*--**-*-----o-*o------o-ooo-o 1" // middlegame
+    , "****---*o-*----------#oo---o---o 1" // middlegame with a king
+    , "8-**---*---*-*-------o-*o---oooo 1" // endgame with a king
+};
+
+
+// positions searched by the bench mode: openings, middlegames and king endgames
+static const char * benchPositions[] = {
+      "****--**o*-*-*------oo-*o-oooooo 1" // openings
+    , "****-****----***----ooooooooo-oo 1"
+    , "*******-**-----*--o-o--*oooooooo 1"
+    , "******-*-***o-*-*o---ooo-ooooooo 1"
+    , "****-****--*-*------ooo*o-oooooo 1"
+    , "******-****---o----oo--ooo-ooooo 1"
+    , "***-*****-*--*-*--o-o-oooo-ooooo 1"
+    , "***-*****------*-*o-o-ooo--ooooo 1"
+    , "******-**-----*--o---oo*--oooooo 1"
+    , "****-*-****-*--*---oooo-oo-ooooo 1"
+    , "-*-*****o*----oo----o---o----o-- 1" // middlegames
+    , "-*-**-**---*-o--o*-----**o-o--oo 1"
+    , "**-*---o*--o-**------oooo---o-o- 1"
+    , "**--**-*--o---o-**o----oo---oo-o 1"
+    , "*------o-*o---o--o---*-------o-o 2"
+    , "**-*-*-----*-*--o--oo---ooo*---- 1"
+    , "**-*---*-----*-oo------oo-o-o--o 1"
+    , "-*-*---*-----***o-----ooo-o-oo-- 1"
+    , "*--**-**----o--*-*----o*o-o-o--- 1"
+    , "**-*---**---*-o---------oo-*oo-- 1"
+    , "---------o-----*-------##-8----- 1" // king endgames
+    , "---8--8-----------*--*---#----#- 1"
+    , "--8-----8----------------#*----- 1"
+    , "----8-----**--*------------##-#- 1"
+    , "8-8--8-------------#------------ 1"
+    , "--8-----*--8--o----o----*----#-- 1"
+    , "-------8--8---oo#--------*--#--- 1"
+    , "---8--o-----------*o------#----- 1"
+    , "-----8-----8-------o-#---------# 1"
+    , "----8o------o----oo#------------ 1"
+};
+/////////////////////////////////////////
+// END  Benchmark position definitions //
+/////////////////////////////////////////
+
+
+
+/////////////////////////////////////
+// BEGIN  Perft helper definitions //
+/////////////////////////////////////
+// perft table slot; check is the key xor the data (the leaf count above the depth), so a slot
+// torn by simultaneous writes from two threads fails verification instead of being used
+typedef struct {
+    uint64_t check;
+    uint64_t data;
+} PerftSlot;
+
+
+typedef struct {
+    std::vector<PerftSlot> slots;
+    uint64_t mask;
+} PerftTable;
+
+
+// leaf nodes below a board; the last ply is counted from the size of the move list
+static uint64_t perft(Checkers::Board const& board, unsigned short player, int depth, PerftTable * table) {
+    Checkers::MoveList moveList;
+    PerftSlot * slot = nullptr;
+    uint64_t key = 0, check, data, nodes = 0;
+    int i;
+
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+    if(depth <= 1) {
+        return depth == 1 ? moveList.size : 1;
+    }
+
+    if(table) {
+        key = Checkers::Game::getKeyFromBoard_andPlayer(board, player);
+        slot = &table->slots[key & table->mask];
+        check = __atomic_load_n(&slot->check, __ATOMIC_RELAXED);
+        data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+        if((check ^ data) == key && (data & 0xFF) == (uint64_t) depth) {
+            return data >> 8;
+        }
+    }
+
+    for(i = 0; i < moveList.size; i++) {
+        nodes += perft(Checkers::Game::getNextBoardFromMove_andBoard(moveList.moves[i], board), ~player & 1, depth - 1, table);
+    }
+
+    if(table) {
+        data = (nodes << 8) | depth;
+        __atomic_store_n(&slot->check, key ^ data, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+    }
+
+    return nodes;
+}
+
+
+// the root moves are shared out among the threads one at a time
+static uint64_t perftRoot(Checkers::Board const& board, unsigned short player, int depth
+                          , unsigned int numThreads, PerftTable * table) {
+    Checkers::MoveList moveList;
+    std::atomic<int> nextMove(0);
+    std::atomic<uint64_t> nodes(0);
+    std::vector<std::thread> threads;
+    unsigned int i;
+
+    if(depth <= 1) {
+        return perft(board, player, depth, table);
+    }
+
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+
+    auto work = [&]() {
+        int move;
+        while((move = nextMove++) < moveList.size) {
+            nodes += perft(Checkers::Game::getNextBoardFromMove_andBoard(moveList.moves[move], board), ~player & 1, depth - 1, table);
+        }
+    };
+
+    for(i = 1; i < numThreads; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return nodes;
+}
+
+
+// a block of the children of every node above the depth (and of the board itself, with no moves left)
+static void collectEvaluationBlocks(  Checkers::Board const& board
+                                    , unsigned short player
+                                    , int depth
+                                    , std::vector<Checkers::EvaluationBlock>& blocks) {
+    Checkers::MoveList moveList;
+    Checkers::Board nextBoard;
+    Checkers::EvaluationBlock block;
+    int i;
+
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+    if(depth <= 0 || !moveList.size) {
+        return;
+    }
+
+    block.size = moveList.size;
+    for(i = 0; i < moveList.size; i++) {
+        nextBoard = Checkers::Game::getNextBoardFromMove_andBoard(moveList.moves[i], board);
+        block.pieces[0][i] = nextBoard.pieces[0];
+        block.pieces[1][i] = nextBoard.pieces[1];
+        block.kings[i] = nextBoard.kings;
+        block.pieceSquareScores[i] = Checkers::Player::getPieceSquareScoreFromBoard(nextBoard);
+    }
+    blocks.push_back(block);
+
+    for(i = 0; i < moveList.size; i++) {
+        collectEvaluationBlocks(Checkers::Game::getNextBoardFromMove_andBoard(moveList.moves[i], board), ~player & 1, depth - 1, blocks);
+    }
+}
+///////////////////////////////////
+// END  Perft helper definitions //
+///////////////////////////////////
+
+
+
+/////////////////////////////////////////////////
+// BEGIN  Reference move generator definitions //
+/////////////////////////////////////////////////
+// a plain move generator working square by square on the coordinates (x and y from 0 to 7), written
+// independently of the bitboard one in checkers.cpp so that runMoveCheck can compare the two
+static uint32_t getBitFromCoordinates(int x, int y) {
+    if(x < 0 || x > 7 || y < 0 || y > 7) {
+        return 0;
+    }
+
+    return 1U << (4 * y + x / 2);
+}
+
+
+static bool isMoveLess(Checkers::Move const& a, Checkers::Move const& b) {
+    if(a.from != b.from) {
+        return a.from < b.from;
+    }
+    if(a.to != b.to) {
+        return a.to < b.to;
+    }
+
+    return a.captures < b.captures;
+}
+
+
+// the jumps on from a square reached with the given pieces captured; a sequence ends where no jump is
+// left, and the same landing square with the same captures is one move whatever the order
+static void addReferenceJumps(  Checkers::Board const& board
+                              , unsigned short player
+                              , uint8_t from
+                              , int x
+                              , int y
+                              , uint32_t captured
+                              , std::vector<Checkers::Move>& moves) {
+    bool king = (board.kings >> from) & 1;
+    bool jumped = false;
+    uint32_t over, land;
+    int dx, dy;
+    size_t i;
+
+    for(dy = -1; dy <= 1; dy += 2) {
+        // regular pieces only jump forward
+        if(!king && dy != (player ? -1 : 1)) {
+            continue;
+        }
+
+        for(dx = -1; dx <= 1; dx += 2) {
+            over = getBitFromCoordinates(x + dx, y + dy);
+            land = getBitFromCoordinates(x + 2 * dx, y + 2 * dy);
+
+            // the piece has left its starting square, and captured pieces stay on the board until the end
+            if(    over && land && (board.pieces[~player & 1] & over) && !(captured & over)
+                && (!((board.pieces[0] | board.pieces[1]) & land) || land == 1U << from)) {
+                jumped = true;
+                addReferenceJumps(board, player, from, x + 2 * dx, y + 2 * dy, captured | over, moves);
+            }
+        }
+    }
+
+    if(!jumped && captured) {
+        Checkers::Move move;
+        move.from = from;
+        move.to = 4 * y + x / 2;
+        move.captures = captured;
+        move.player = player;
+
+        for(i = 0; i < moves.size(); i++) {
+            if(moves[i].from == move.from && moves[i].to == move.to && moves[i].captures == move.captures) {
+                return;
+            }
+        }
+        moves.push_back(move);
+    }
+}
+
+
+// the moves of a player (jumps are forced), sorted; mobility is counted as getMobilityFromBoard_andPlayer does
+static std::vector<Checkers::Move> getReferenceMoves(Checkers::Board const& board, unsigned short player, int& mobility) {
+    std::vector<Checkers::Move> moves;
+    Checkers::Move move;
+    uint32_t over, land;
+    int square, x, y, dx, dy, firstJumps = 0;
+    bool king;
+
+    for(square = 0; square < 32; square++) {
+        if((board.pieces[player] >> square) & 1) {
+            y = square >> 2;
+            x = 2 * (square & 3) + (y & 1);
+            addReferenceJumps(board, player, square, x, y, 0, moves);
+
+            king = (board.kings >> square) & 1;
+            for(dy = -1; dy <= 1; dy += 2) {
+                for(dx = -1; dx <= 1; dx += 2) {
+                    over = getBitFromCoordinates(x + dx, y + dy);
+                    land = getBitFromCoordinates(x + 2 * dx, y + 2 * dy);
+                    firstJumps +=    (king || dy == (player ? -1 : 1)) && over && land && (board.pieces[~player & 1] & over)
+                                  && !((board.pieces[0] | board.pieces[1]) & land);
+                }
+            }
+        }
+    }
+
+    if(!moves.empty()) {
+        mobility = firstJumps;
+        std::sort(moves.begin(), moves.end(), isMoveLess);
+        return moves;
+    }
+
+    move.captures = 0;
+    move.player = player;
+    for(square = 0; square < 32; square++) {
+        if((board.pieces[player] >> square) & 1) {
+            y = square >> 2;
+            x = 2 * (square & 3) + (y & 1);
+            king = (board.kings >> square) & 1;
+
+            for(dy = -1; dy <= 1; dy += 2) {
+                for(dx = -1; dx <= 1; dx += 2) {
+                    land = getBitFromCoordinates(x + dx, y + dy);
+                    if((king || dy == (player ? -1 : 1)) && land && !((board.pieces[0] | board.pieces[1]) & land)) {
+                        move.from = square;
+                        move.to = __builtin_ctz(land);
+                        moves.push_back(move);
+                    }
+                }
+            }
+        }
+    }
+
+    mobility = moves.size();
+    std::sort(moves.begin(), moves.end(), isMoveLess);
+
+    return moves;
+}
+
+
+// the checks of one board with a player to move: the moves against the reference generator, the move
+// tests against the moves, and making each move in place (with the key and score updates) against
+// building the next board; returns the number of checks which failed
+static uint64_t checkMovesFromBoard_andPlayer(Checkers::Board const& board, unsigned short player) {
+    Checkers::MoveList moveList;
+    Checkers::MoveUndo undo;
+    Checkers::Board nextBoard, madeBoard;
+    std::vector<Checkers::Move> moves, references;
+    uint64_t key = Checkers::Game::getKeyFromBoard_andPlayer(board, player), failures = 0;
+    int i, mobility;
+    size_t j;
+
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+    moves.assign(moveList.moves, moveList.moves + moveList.size);
+    std::sort(moves.begin(), moves.end(), isMoveLess);
+    references = getReferenceMoves(board, player, mobility);
+
+    failures += moves.size() != references.size();
+    for(j = 0; j < moves.size() && j < references.size(); j++) {
+        failures +=    moves[j].from != references[j].from || moves[j].to != references[j].to
+                    || moves[j].captures != references[j].captures || moves[j].player != references[j].player;
+    }
+
+    failures += Checkers::Game::hasMoveFromBoard_andPlayer(board, player) != !references.empty();
+    failures += Checkers::Game::hasCaptureFromBoard_andPlayer(board, player) != (!references.empty() && references[0].captures);
+    failures += Checkers::Game::getMobilityFromBoard_andPlayer(board, player) != mobility;
+
+    for(i = 0; i < moveList.size; i++) {
+        nextBoard = Checkers::Game::getNextBoardFromMove_andBoard(moveList.moves[i], board);
+        madeBoard = board;
+        Checkers::Game::makeMoveOnBoard(moveList.moves[i], madeBoard, undo);
+
+        failures +=    madeBoard.pieces[0] != nextBoard.pieces[0] || madeBoard.pieces[1] != nextBoard.pieces[1]
+                    || madeBoard.kings != nextBoard.kings;
+        failures += Checkers::Game::getNextKeyFromMoveUndo(key, undo) != Checkers::Game::getKeyFromBoard_andPlayer(nextBoard, ~player & 1);
+        failures +=    Checkers::Player::getNextPieceSquareScoreFromMoveUndo(Checkers::Player::getPieceSquareScoreFromBoard(board), undo)
+                    != Checkers::Player::getPieceSquareScoreFromBoard(nextBoard);
+
+        Checkers::Game::unmakeMoveOnBoard(undo, madeBoard);
+        failures +=    madeBoard.pieces[0] != board.pieces[0] || madeBoard.pieces[1] != board.pieces[1]
+                    || madeBoard.kings != board.kings;
+    }
+
+    return failures;
+}
+
+
+// every node of the tree to the depth is checked with either player to move
+static void checkMovesFromTree(  Checkers::Board const& board
+                               , unsigned short player
+                               , int depth
+                               , uint64_t& numBoards
+                               , uint64_t& failures) {
+    Checkers::MoveList moveList;
+    uint64_t boardFailures = checkMovesFromBoard_andPlayer(board, 0) + checkMovesFromBoard_andPlayer(board, 1);
+    int i;
+
+    numBoards++;
+    if(boardFailures && !failures) {
+        std::cout << "First mismatch: " << Checkers::Game::getStringFromBoard_andPlayer(board, player) << std::endl;
+    }
+    failures += boardFailures;
+
+    if(depth <= 0) {
+        return;
+    }
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+    for(i = 0; i < moveList.size; i++) {
+        checkMovesFromTree(Checkers::Game::getNextBoardFromMove_andBoard(moveList.moves[i], board), ~player & 1, depth - 1, numBoards, failures);
+    }
+}
+///////////////////////////////////////////////
+// END  Reference move generator definitions //
+///////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////////////////////
+// BEGIN  Benchmark method definitions (in order of appearance in benchmark.hpp) //
+///////////////////////////////////////////////////////////////////////////////////
+void Checkers::Benchmark::reportThreadScaling(int depth) {
+    const unsigned int threadCounts[5] = {1, 2, 4, 8, 16};
+    const unsigned int numPositions = sizeof(scalingPositions) / sizeof(scalingPositions[0]);
+    unsigned int i, j;
+    unsigned short playerTurn;
+    double seconds, baseSeconds = 0;
+    uint64_t nodes;
+    Checkers::Board board;
+    Checkers::SearchLimits limits = {1e9, 0, depth, 0};
+    Checkers::SearchResult result;
+
+    std::cout << "Time to depth " << depth << " over " << numPositions << " positions" << std::endl;
+    std::cout << std::setw(10) << "threads" << std::setw(14) << "time (s)" << std::setw(16) << "nodes"
+              << std::setw(14) << "nodes/s" << std::setw(12) << "speedup" << std::endl;
+
+    for(i = 0; i < 5; i++) {
+        limits.threads = threadCounts[i];
+        seconds = 0;
+        nodes = 0;
+
+        for(j = 0; j < numPositions; j++) {
+            Checkers::Game::getBoardFromString(scalingPositions[j], board, playerTurn);
+
+            // every run starts from an empty table and without the tablebase, and only the depth limit ends the search
+            Checkers::Player player(nullptr, true, 0, false);
+            result = player.search(board, playerTurn, limits);
+
+            seconds += result.info.seconds;
+            nodes += result.info.nodes;
+        }
+
+        if(i == 0) {
+            baseSeconds = seconds;
+        }
+
+        std::cout << std::setw(10) << threadCounts[i]
+                  << std::setw(14) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(16) << nodes
+                  << std::setw(14) << std::setprecision(0) << nodes / std::max(seconds, 1e-9)
+                  << std::setw(12) << std::setprecision(2) << baseSeconds / std::max(seconds, 1e-9) << std::endl;
+    }
+}
+
+
+// each line of a perft file is a position string, then ';' and its leaf counts for depths 1, 2, ...
+// (lines starting with '#' are comments); returns false if any count differs from its reference
+bool Checkers::Benchmark::runPerft(std::string const& filePath, int depth, unsigned int numThreads, unsigned int hashSize) {
+    std::ifstream file(filePath);
+    std::string line, position;
+    std::vector<std::string> positions;
+    std::vector<std::vector<uint64_t> > references;
+    uint64_t count, nodes, totalNodes = 0;
+    double seconds, totalSeconds = 0;
+    unsigned short playerTurn;
+    unsigned int i, failures = 0;
+    size_t separator;
+    Checkers::Board board;
+    Checkers::Time ti;
+    PerftTable table;
+
+    if(!file.is_open()) {
+        std::cout << "Could not open perft file '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    while(std::getline(file, line)) {
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        separator = line.find(';');
+        position = line.substr(0, separator);
+        if(!Checkers::Game::getBoardFromString(position, board, playerTurn)) {
+            std::cout << "Skipping invalid position '" << position << "'" << std::endl;
+            continue;
+        }
+
+        positions.push_back(position.substr(0, 34));
+        references.push_back(std::vector<uint64_t>());
+        if(separator != std::string::npos) {
+            std::istringstream counts(line.substr(separator + 1));
+            while(counts >> count) {
+                references.back().push_back(count);
+            }
+        }
+    }
+
+    // a power of two number of slots, so the low bits of a key pick its slot
+    if(hashSize) {
+        table.mask = 1;
+        while(2 * (table.mask + 1) * sizeof(PerftSlot) <= (uint64_t) hashSize << 20) {
+            table.mask = 2 * table.mask + 1;
+        }
+        table.slots.resize(table.mask + 1);
+    }
+
+    numThreads = std::max(1U, numThreads);
+
+    std::cout << "Perft to depth " << depth << " with " << numThreads << " thread(s) and "
+              << (hashSize ? std::to_string(hashSize) + " MB hash" : std::string("no hash")) << std::endl;
+    std::cout << std::setw(36) << std::left << "position" << std::right << std::setw(16) << "nodes"
+              << std::setw(16) << "reference" << std::setw(12) << "time (s)" << std::setw(14) << "nodes/s"
+              << std::setw(8) << "result" << std::endl;
+
+    for(i = 0; i < positions.size(); i++) {
+        Checkers::Game::getBoardFromString(positions[i], board, playerTurn);
+
+        // entries of the previous position would still be correct, but would flatter its speed
+        std::fill(table.slots.begin(), table.slots.end(), PerftSlot());
+
+        ti = Checkers::Clock::now();
+        nodes = perftRoot(board, playerTurn, depth, numThreads, hashSize ? &table : nullptr);
+        seconds = std::chrono::duration<double>(Checkers::Clock::now() - ti).count();
+
+        totalNodes += nodes;
+        totalSeconds += seconds;
+
+        std::cout << std::setw(36) << std::left << positions[i] << std::right << std::setw(16) << nodes;
+        if(depth >= 1 && (unsigned int) depth <= references[i].size()) {
+            std::cout << std::setw(16) << references[i][depth - 1];
+        } else {
+            std::cout << std::setw(16) << "-";
+        }
+        std::cout << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(14) << std::setprecision(0) << nodes / std::max(seconds, 1e-9);
+
+        if(depth < 1 || (unsigned int) depth > references[i].size()) {
+            std::cout << std::setw(8) << "-" << std::endl;
+        } else if(nodes == references[i][depth - 1]) {
+            std::cout << std::setw(8) << "ok" << std::endl;
+        } else {
+            std::cout << std::setw(8) << "FAIL" << std::endl;
+            failures++;
+        }
+    }
+
+    std::cout << std::setw(36) << std::left << "total" << std::right << std::setw(16) << totalNodes
+              << std::setw(16) << "" << std::setw(12) << std::setprecision(3) << totalSeconds
+              << std::setw(14) << std::setprecision(0) << totalNodes / std::max(totalSeconds, 1e-9)
+              << std::setw(8) << (failures ? "FAIL" : "ok") << std::endl;
+
+    return !failures;
+}
+
+
+// a single search thread keeps the node counts reproducible, so the signature (a hash of the node
+// count of every position) only changes when the search does
+uint64_t Checkers::Benchmark::runBench(int depth) {
+    const unsigned int numPositions = sizeof(benchPositions) / sizeof(benchPositions[0]);
+    unsigned int i;
+    unsigned short playerTurn;
+    double seconds, totalSeconds = 0;
+    uint64_t nodes, totalNodes = 0, totalQuiescenceNodes = 0;
+    uint64_t signature = 0xCBF29CE484222325ULL;
+    Checkers::Board board;
+    Checkers::SearchLimits limits = {1e9, 0, depth, 1};
+    Checkers::SearchResult result;
+
+    std::cout << "Search to depth " << depth << " over " << numPositions << " positions" << std::endl;
+    std::cout << std::setw(4) << "#" << "  " << std::setw(36) << std::left << "position" << std::right
+              << std::setw(14) << "nodes" << std::setw(12) << "time (s)" << std::setw(14) << "nodes/s"
+              << "  move" << std::endl;
+
+    for(i = 0; i < numPositions; i++) {
+        Checkers::Game::getBoardFromString(benchPositions[i], board, playerTurn);
+
+        // every search starts from an empty table and without the tablebase, and only the depth limit ends the search
+        Checkers::Player player(nullptr, true, 0, false);
+        result = player.search(board, playerTurn, limits);
+
+        seconds = result.info.seconds;
+        nodes = result.info.nodes;
+        totalSeconds += seconds;
+        totalNodes += nodes;
+        totalQuiescenceNodes += player.getQuiescenceNodeCount();
+        signature = (signature ^ nodes) * 0x100000001B3ULL;
+
+        std::cout << std::setw(4) << i + 1 << "  " << std::setw(36) << std::left << benchPositions[i] << std::right
+                  << std::setw(14) << nodes
+                  << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(14) << std::setprecision(0) << nodes / std::max(seconds, 1e-9)
+                  << "  " << Checkers::Game::parseMove(result.move) << std::endl;
+    }
+
+    std::cout << "Total time (s) : " << std::setprecision(3) << totalSeconds << std::endl;
+    std::cout << "Total nodes    : " << totalNodes << std::endl;
+    std::cout << "  quiescence   : " << totalQuiescenceNodes << std::endl;
+    std::cout << "Nodes/s        : " << std::setprecision(0) << totalNodes / std::max(totalSeconds, 1e-9) << std::endl;
+    std::cout << "Signature      : " << std::hex << std::setw(16) << std::setfill('0') << signature
+              << std::dec << std::setfill(' ') << std::endl;
+
+    return signature;
+}
+
+
+// the scalar kernel gives the reference scores, and each block is scored for both players (as the
+// evaluation depends on the player it scores for); the blocks are scored a few times for a steadier time
+bool Checkers::Benchmark::runEvaluation(int depth) {
+    const unsigned int numPositions = sizeof(benchPositions) / sizeof(benchPositions[0]);
+    const Checkers::EvaluationKernel kernels[3] = {Checkers::scalarKernel, Checkers::sse2Kernel, Checkers::avx2Kernel};
+    const char * kernelNames[3] = {"scalar", "sse2", "avx2"};
+    const int repetitions = 5;
+    std::vector<Checkers::EvaluationBlock> blocks;
+    std::vector<int> references, scores;
+    unsigned short playerTurn;
+    unsigned int i, k;
+    uint64_t numBoards = 0, mismatches, failures = 0;
+    double seconds, baseSeconds = 0;
+    size_t b, offset;
+    int r, j;
+    uint8_t me;
+    Checkers::Board board;
+    Checkers::Player player;
+    Checkers::Time ti;
+
+    for(i = 0; i < numPositions; i++) {
+        Checkers::Game::getBoardFromString(benchPositions[i], board, playerTurn);
+        collectEvaluationBlocks(board, playerTurn, depth, blocks);
+    }
+    for(b = 0; b < blocks.size(); b++) {
+        numBoards += blocks[b].size;
+    }
+    references.resize(2 * numBoards);
+    scores.resize(2 * numBoards);
+
+    std::cout << "Evaluation of " << numBoards << " boards in " << blocks.size() << " blocks (children of every node to depth "
+              << depth << " over " << numPositions << " positions)" << std::endl;
+    std::cout << std::setw(10) << "kernel" << std::setw(12) << "time (s)" << std::setw(14) << "boards/s"
+              << std::setw(12) << "speedup" << std::setw(14) << "mismatches" << std::endl;
+
+    for(k = 0; k < 3; k++) {
+        if(!Checkers::Player::isEvaluationKernelSupported(kernels[k])) {
+            std::cout << std::setw(10) << kernelNames[k] << "  not supported" << std::endl;
+            continue;
+        }
+
+        ti = Checkers::Clock::now();
+        for(r = 0; r < repetitions; r++) {
+            for(me = 0, offset = 0; me < 2; me++) {
+                player.setSearchPlayer(me);
+                for(b = 0; b < blocks.size(); b++) {
+                    player.evaluateBlock(blocks[b], &scores[offset], kernels[k]);
+                    offset += blocks[b].size;
+                }
+            }
+        }
+        seconds = std::chrono::duration<double>(Checkers::Clock::now() - ti).count();
+
+        if(!k) {
+            references = scores;
+            baseSeconds = seconds;
+        }
+
+        mismatches = 0;
+        for(b = 0; b < scores.size(); b++) {
+            mismatches += scores[b] != references[b];
+        }
+        failures += mismatches;
+
+        std::cout << std::setw(10) << kernelNames[k]
+                  << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(14) << std::setprecision(0) << repetitions * 2 * numBoards / std::max(seconds, 1e-9)
+                  << std::setw(12) << std::setprecision(2) << baseSeconds / std::max(seconds, 1e-9)
+                  << std::setw(14) << mismatches << std::endl;
+    }
+
+    // the scalar kernel itself is checked against evaluateBoard on each board
+    for(me = 0, offset = 0; me < 2; me++) {
+        player.setSearchPlayer(me);
+        for(b = 0; b < blocks.size(); b++) {
+            for(j = 0; j < blocks[b].size; j++, offset++) {
+                board.pieces[0] = blocks[b].pieces[0][j];
+                board.pieces[1] = blocks[b].pieces[1][j];
+                board.kings = blocks[b].kings[j];
+                failures += player.evaluateBoard(board) != references[offset];
+            }
+        }
+    }
+
+    std::cout << (failures ? "FAIL" : "ok") << std::endl;
+
+    return !failures;
+}
+
+
+bool Checkers::Benchmark::runMoveCheck(int depth) {
+    const unsigned int numPositions = sizeof(benchPositions) / sizeof(benchPositions[0]);
+    unsigned short playerTurn;
+    unsigned int i;
+    uint64_t numBoards = 0, failures = 0;
+    Checkers::Board board;
+    Checkers::Time ti = Checkers::Clock::now();
+
+    for(i = 0; i < numPositions; i++) {
+        Checkers::Game::getBoardFromString(benchPositions[i], board, playerTurn);
+        checkMovesFromTree(board, playerTurn, depth, numBoards, failures);
+    }
+
+    std::cout << "Checked " << numBoards << " boards with either player to move (every node to depth " << depth
+              << " over " << numPositions << " positions) in " << std::fixed << std::setprecision(3)
+              << std::chrono::duration<double>(Checkers::Clock::now() - ti).count() << " s: " << failures << " mismatches" << std::endl;
+    std::cout << (failures ? "FAIL" : "ok") << std::endl;
+
+    return !failures;
+}
+///////////////////////////////////////
+// END  Benchmark method definitions //
+///////////////////////////////////////
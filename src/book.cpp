@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <atomic>
+#include <checkers.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+
+///////////////////////////////////////////
+// BEGIN  OpeningBook helper definitions //
+///////////////////////////////////////////
+// a book file is a header, then the entries sorted by key (and by move within a key)
+typedef struct {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t numEntries;
+} BookHeader;
+
+static const uint32_t bookMagic = 0x314B4243U; // "CBK1"
+
+
+static inline bool isBookEntryLess(Checkers::BookEntry const& a, Checkers::BookEntry const& b) {
+    if(a.key != b.key) {
+        return a.key < b.key;
+    } else if(a.from != b.from) {
+        return a.from < b.from;
+    } else if(a.to != b.to) {
+        return a.to < b.to;
+    }
+
+    return a.captures < b.captures;
+}
+/////////////////////////////////////////
+// END  OpeningBook helper definitions //
+/////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////////////////////////////
+// BEGIN  OpeningBook method definitions (in order of appearance in checkers.hpp) //
+////////////////////////////////////////////////////////////////////////////////////
+Checkers::OpeningBook::OpeningBook() {
+    this->entries = nullptr;
+    this->numEntries = 0;
+}
+
+
+// each game starts with either player and plays zero to three random moves (so the games differ), then
+// both sides are searched to the fixed depth and their moves are recorded for the first book plies;
+// the search runs on one thread per game, so the games themselves are played in parallel
+bool Checkers::OpeningBook::generate(  std::string const& filePath
+                                     , unsigned int numGames
+                                     , int depth
+                                     , int plies
+                                     , unsigned int numThreads) {
+    std::vector<Checkers::BookEntry> entries;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned int> nextGame(0);
+    std::mutex entriesMutex;
+    BookHeader header;
+    size_t i, j;
+    unsigned int t;
+
+    numThreads = std::max(1U, numThreads);
+
+    std::cout << "Playing " << numGames << " games to depth " << depth << " for a " << plies
+              << " ply book with " << numThreads << " thread(s)" << std::endl;
+
+    auto worker = [&]() {
+        std::vector<Checkers::BookEntry> gameEntries;
+        std::vector<Checkers::Move> moveList;
+        Checkers::BookEntry entry;
+        Checkers::SearchLimits limits = {1e9, 0, depth, 1};
+        Checkers::Board board;
+        Checkers::Move move;
+        unsigned short player;
+        unsigned int game;
+        int ply, randomPlies;
+
+        while((game = nextGame++) < numGames) {
+            std::mt19937 rng(game);
+            Checkers::Player players[2] = {
+                  Checkers::Player(nullptr, true, 0)
+                , Checkers::Player(nullptr, true, 0)
+            };
+
+            board = Checkers::Game::getStartBoard();
+            player = game & 1;
+            randomPlies = (game >> 1) & 3;
+            gameEntries.clear();
+
+            for(ply = 0; ply < plies; ply++) {
+                moveList = Checkers::Game::getMovesFromBoard_andPlayer(board, player);
+                if(moveList.empty()) {
+                    break;
+                }
+
+                if(ply < randomPlies) {
+                    move = moveList[rng() % moveList.size()];
+                }
+
+                else {
+                    move = players[player].search(board, player, limits).move;
+
+                    // forced moves are played without a search anyway
+                    if(moveList.size() > 1) {
+                        entry.key = Checkers::Game::getKeyFromBoard_andPlayer(board, player);
+                        entry.captures = move.captures;
+                        entry.from = move.from;
+                        entry.to = move.to;
+                        entry.weight = 1;
+                        gameEntries.push_back(entry);
+                    }
+                }
+
+                board = Checkers::Game::getNextBoardFromMove_andBoard(move, board);
+                player = ~player & 1;
+            }
+
+            std::lock_guard<std::mutex> lock(entriesMutex);
+            entries.insert(entries.end(), gameEntries.begin(), gameEntries.end());
+            if((game + 1) % 10 == 0 || game + 1 == numGames) {
+                std::cout << "  game " << game + 1 << " done, " << entries.size() << " book moves recorded" << std::endl;
+            }
+        }
+    };
+
+    for(t = 1; t < numThreads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // merge the same move of the same position into one entry, adding up the weights
+    std::sort(entries.begin(), entries.end(), isBookEntryLess);
+    for(i = j = 0; i < entries.size(); i++) {
+        if(j && !isBookEntryLess(entries[j - 1], entries[i])) {
+            entries[j - 1].weight = std::min(entries[j - 1].weight + entries[i].weight, 0xFFFF);
+        } else {
+            entries[j++] = entries[i];
+        }
+    }
+    entries.resize(j);
+
+    header.magic = bookMagic;
+    header.reserved = 0;
+    header.numEntries = entries.size();
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if(    !file.write((char const *) &header, sizeof(header))
+        || !file.write((char const *) entries.data(), entries.size() * sizeof(Checkers::BookEntry))) {
+        std::cout << "Could not write opening book file '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote " << entries.size() << " book entries to '" << filePath << "'" << std::endl;
+
+    return true;
+}
+
+
+bool Checkers::OpeningBook::open(std::string const& filePath) {
+    BookHeader header;
+    struct stat fileStat;
+    void * address;
+    int fd;
+
+    this->close();
+
+    fd = ::open(filePath.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    if(fstat(fd, &fileStat) || (uint64_t) fileStat.st_size < sizeof(header)) {
+        ::close(fd);
+        return false;
+    }
+
+    address = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED) {
+        return false;
+    }
+
+    size_t size = fileStat.st_size;
+    std::shared_ptr<const uint8_t> mapping((uint8_t const *) address, [size](uint8_t const * address) {
+        munmap((void *) address, size);
+    });
+
+    header = *(BookHeader const *) address;
+    if(header.magic != bookMagic || size != sizeof(header) + header.numEntries * sizeof(Checkers::BookEntry)) {
+        return false;
+    }
+
+    this->mapping = mapping;
+    this->entries = (Checkers::BookEntry const *) (mapping.get() + sizeof(header));
+    this->numEntries = header.numEntries;
+
+    return true;
+}
+
+
+void Checkers::OpeningBook::close() {
+    this->mapping.reset();
+    this->entries = nullptr;
+    this->numEntries = 0;
+}
+
+
+// a book move must also be legal on the board, which guards against key collisions
+bool Checkers::OpeningBook::probe(Board const& board, unsigned short player, Move& move) {
+    Checkers::BookEntry const * first, * last, * entry;
+    Checkers::BookEntry target;
+    Checkers::MoveList moveList;
+    Checkers::Move legalMoves[Checkers::maxMoves];
+    unsigned int weights[Checkers::maxMoves];
+    unsigned int totalWeight = 0, pick;
+    int i, numMoves = 0;
+
+    if(!this->mapping) {
+        return false;
+    }
+
+    target.key = Checkers::Game::getKeyFromBoard_andPlayer(board, player);
+    target.from = target.to = 0;
+    target.captures = 0;
+
+    first = std::lower_bound(this->entries, this->entries + this->numEntries, target, isBookEntryLess);
+    for(last = first; last != this->entries + this->numEntries && last->key == target.key; last++);
+    if(first == last) {
+        return false;
+    }
+
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+    for(entry = first; entry != last; entry++) {
+        for(i = 0; i < moveList.size; i++) {
+            if(    moveList.moves[i].from == entry->from && moveList.moves[i].to == entry->to
+                && moveList.moves[i].captures == entry->captures) {
+                legalMoves[numMoves] = moveList.moves[i];
+                weights[numMoves++] = entry->weight;
+                totalWeight += entry->weight;
+                break;
+            }
+        }
+    }
+
+    if(!totalWeight) {
+        return false;
+    }
+
+    pick = std::rand() % totalWeight;
+    for(i = 0; pick >= weights[i]; i++) {
+        pick -= weights[i];
+    }
+    move = legalMoves[i];
+
+    return true;
+}
+/////////////////////////////////////////
+// END  OpeningBook method definitions //
+/////////////////////////////////////////
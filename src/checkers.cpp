@@ -1,19 +1,20 @@
-// TODO:  (1) use transposition tables for seen board positions (reduce evaluation calculation)
-//        (2) perform smart move ordering on minimax tree (increases pruning frequency)
-//        (3) increase operation efficiency by using efficient data structures
-//        (4) clean up naming / code in general for readability and brevity (along with efficiency)
-//  Most of this is in the name of increasing search depths in the minimax tree
+// TODO:  (4) clean up naming / code in general for readability and brevity (along with efficiency)
 #include <algorithm>
 #include <checkers.hpp>
 #include <climits>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
-#include <ctime>
 #include <fstream>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <termcolor.hpp>
+#include <thread>
 
 
 
@@ -40,13 +41,750 @@ char Checkers::columnMap[8] = {
 unsigned int Checkers::timeLimitLower = 3;
 unsigned int Checkers::timeLimitUpper = 60;
 unsigned int Checkers::moveLimit = 50;
+unsigned int Checkers::repetitionLimit = 3; // occurrences of a position (with the same player to move) drawing a game
 double Checkers::timeRemainingThreshold = 0.1; // in seconds
+unsigned int Checkers::timeCheckInterval = 1024; // in nodes
+unsigned int Checkers::movesToGo = 25;           // moves expected of each player in the rest of a game
+unsigned int Checkers::transpositionTableSize = 32; // in megabytes
+unsigned int Checkers::searchThreads = std::max(1U, std::thread::hardware_concurrency());
+std::string Checkers::tablebaseFilePath = "data/endgame.tb";
+std::string Checkers::openingBookFilePath = "data/opening.book";
 ////////////////////////////////////
 // END  Player method definitions //
 ////////////////////////////////////
 
 
 
+////////////////////////////////////////
+// BEGIN  Bitboard helper definitions //
+////////////////////////////////////////
+// a diagonal step changes the square number by 3, 4 or 5 depending on the row parity;
+// directions are indexed as top right (0), top left (1), bottom left (2), bottom right (3)
+static const uint32_t rowMasks[2] = {
+      0x0F0F0F0FU // even rows (1, 3, 5, 7)
+    , 0xF0F0F0F0U // odd rows (2, 4, 6, 8)
+};
+static const uint32_t backRanks[2] = {
+      0x0000000FU // Player 1 (row 1)
+    , 0xF0000000U // Player 2 (row 8)
+};
+static const int stepOffsets[2][4] = {
+      {4, 3, -5, -4} // from even rows
+    , {5, 4, -4, -3} // from odd rows
+};
+static const int jumpOffsets[4] = {9, 7, -9, -7};
+static const uint32_t stepMasks[4] = {0x0F7F7F7FU, 0x0EFEFEFEU, 0xFEFEFEF0U, 0x7F7F7F70U}; // step stays on board
+static const uint32_t jumpMasks[4] = {0x00777777U, 0x00EEEEEEU, 0xEEEEEE00U, 0x77777700U}; // jump stays on board
+static const uint8_t manDirections[2] = {0x3U, 0xCU}; // regular pieces only move forward; kings use 0xF
+
+
+static inline uint32_t shiftBits(uint32_t bits, int offset) {
+    return offset > 0 ? bits << offset : bits >> -offset;
+}
+
+
+// squares which reach one of the given squares by stepping in a direction
+static inline uint32_t stepToBits(uint32_t bits, int direction) {
+    return stepMasks[direction] & (  (rowMasks[0] & shiftBits(bits, -stepOffsets[0][direction]))
+                                   | (rowMasks[1] & shiftBits(bits, -stepOffsets[1][direction])));
+}
+
+
+// per-square tables, built at compile time from the coordinates of each square (x and y from 0 to 7)
+static constexpr int getXFromSquare(int square) {
+    return ((square & 3) << 1) | ((square >> 2) & 1);
+}
+
+
+static constexpr int getDistance(int a, int b) {
+    return a > b ? a - b : b - a;
+}
+
+
+// bit of the square n steps away in a direction, or 0 off the board
+static constexpr uint32_t getBitFromSquare_andDirection(int square, int direction, int n) {
+    return    getXFromSquare(square) + n * (direction == 0 || direction == 3 ? 1 : -1) >= 0
+           && getXFromSquare(square) + n * (direction == 0 || direction == 3 ? 1 : -1) <= 7
+           && (square >> 2) + n * (direction < 2 ? 1 : -1) >= 0
+           && (square >> 2) + n * (direction < 2 ? 1 : -1) <= 7
+           ? 1U << (  4 * ((square >> 2) + n * (direction < 2 ? 1 : -1))
+                    + ((getXFromSquare(square) + n * (direction == 0 || direction == 3 ? 1 : -1)) >> 1))
+           : 0;
+}
+
+
+// the piece-square value of a player's king (1) or regular piece (0) on a square:
+// control the center, kings are worth 80% more than regular pieces, advance regular pieces,
+// and keep regular pieces on back rank if possible
+static constexpr int getPieceSquareValue(int player, int king, int square) {
+    return  3 * (100 - ((getDistance(4, getXFromSquare(square)) + getDistance(4, square >> 2)) * 10))
+          + (king ? 15 * 180 : 15 * 100 + 5 * (10 * getDistance(7 * player, square >> 2)) + ((square >> 2) == 7 * player ? 300 : 0));
+}
+
+
+template<int... squares>
+struct SquareTables {
+    static constexpr uint32_t stepBits[32][4] = {{  getBitFromSquare_andDirection(squares, 0, 1), getBitFromSquare_andDirection(squares, 1, 1)
+                                                  , getBitFromSquare_andDirection(squares, 2, 1), getBitFromSquare_andDirection(squares, 3, 1)}...};
+    // a jump only lands on the board when the square jumped over is on it too
+    static constexpr uint32_t jumpBits[32][4] = {{  getBitFromSquare_andDirection(squares, 0, 2), getBitFromSquare_andDirection(squares, 1, 2)
+                                                  , getBitFromSquare_andDirection(squares, 2, 2), getBitFromSquare_andDirection(squares, 3, 2)}...};
+    // indexed by player, king (1) or regular piece (0), and square
+    static constexpr int pieceSquareValues[2][2][32] = {
+          {{getPieceSquareValue(0, 0, squares)...}, {getPieceSquareValue(0, 1, squares)...}}
+        , {{getPieceSquareValue(1, 0, squares)...}, {getPieceSquareValue(1, 1, squares)...}}
+    };
+};
+template<int... squares> constexpr uint32_t SquareTables<squares...>::stepBits[32][4];
+template<int... squares> constexpr uint32_t SquareTables<squares...>::jumpBits[32][4];
+template<int... squares> constexpr int SquareTables<squares...>::pieceSquareValues[2][2][32];
+
+
+// the squares 0 to 31 as a parameter pack
+template<int n, int... squares>
+struct SquareSequence : SquareSequence<n - 1, n - 1, squares...> {};
+template<int... squares>
+struct SquareSequence<0, squares...> {
+    typedef SquareTables<squares...> Tables;
+};
+typedef SquareSequence<32>::Tables squareTables;
+static_assert(  squareTables::stepBits[0][0] == 1U << 4 && squareTables::jumpBits[0][0] == 1U << 9 && !squareTables::stepBits[0][2]
+              , "the square tables disagree with the step and jump offsets");
+
+
+// pieces of a player able to move in a direction (regular pieces only move forward); the player and
+// the direction are template arguments so that the masks and shifts fold into constants
+template<unsigned short player, int direction>
+static inline uint32_t getMoversFromBoard(Checkers::Board const& board) {
+    return board.pieces[player] & ((manDirections[player] >> direction) & 1 ? ~0U : board.kings);
+}
+
+
+// pieces of a player able to start a jump in a direction (an enemy piece next to them, and an empty square behind it)
+template<unsigned short player, int direction>
+static inline uint32_t getJumpersFromBoard(Checkers::Board const& board, uint32_t empty) {
+    return  getMoversFromBoard<player, direction>(board) & jumpMasks[direction]
+          & stepToBits(board.pieces[~player & 1], direction) & shiftBits(empty, -jumpOffsets[direction]);
+}
+
+
+template<unsigned short player>
+static inline uint32_t getJumpersFromBoard(Checkers::Board const& board) {
+    uint32_t empty = ~(board.pieces[0] | board.pieces[1]);
+
+    return  getJumpersFromBoard<player, 0>(board, empty) | getJumpersFromBoard<player, 1>(board, empty)
+          | getJumpersFromBoard<player, 2>(board, empty) | getJumpersFromBoard<player, 3>(board, empty);
+}
+
+
+// pieces of a player able to make a simple move
+template<unsigned short player>
+static inline uint32_t getSteppersFromBoard(Checkers::Board const& board) {
+    uint32_t empty = ~(board.pieces[0] | board.pieces[1]);
+
+    return  (getMoversFromBoard<player, 0>(board) & stepToBits(empty, 0)) | (getMoversFromBoard<player, 1>(board) & stepToBits(empty, 1))
+          | (getMoversFromBoard<player, 2>(board) & stepToBits(empty, 2)) | (getMoversFromBoard<player, 3>(board) & stepToBits(empty, 3));
+}
+
+
+// the side-dependent evaluation terms: regular pieces protected by own pieces on the two squares behind
+// them, and enemy pieces challenged two squares straight ahead
+template<unsigned short player>
+static inline int getNeighbourScoreFromBoard(Checkers::Board const& board) {
+    uint32_t men = board.pieces[player] & ~board.kings;
+
+    return  150 * __builtin_popcount(men & stepToBits(board.pieces[player], player ? 0 : 2))
+          + 150 * __builtin_popcount(men & stepToBits(board.pieces[player], player ? 1 : 3))
+          + 100 * __builtin_popcount(men & ~backRanks[player] & shiftBits(board.pieces[~player & 1], player ? 8 : -8));
+}
+
+
+// the number of simple moves, or the number of first jumps with a capture pending
+template<unsigned short player>
+static inline int getMobilityFromBoard(Checkers::Board const& board) {
+    uint32_t empty = ~(board.pieces[0] | board.pieces[1]);
+    uint32_t jumpers[4] = {  getJumpersFromBoard<player, 0>(board, empty), getJumpersFromBoard<player, 1>(board, empty)
+                           , getJumpersFromBoard<player, 2>(board, empty), getJumpersFromBoard<player, 3>(board, empty)};
+
+    if(jumpers[0] | jumpers[1] | jumpers[2] | jumpers[3]) {
+        return  __builtin_popcount(jumpers[0]) + __builtin_popcount(jumpers[1])
+              + __builtin_popcount(jumpers[2]) + __builtin_popcount(jumpers[3]);
+    }
+
+    return  __builtin_popcount(getMoversFromBoard<player, 0>(board) & stepToBits(empty, 0))
+          + __builtin_popcount(getMoversFromBoard<player, 1>(board) & stepToBits(empty, 1))
+          + __builtin_popcount(getMoversFromBoard<player, 2>(board) & stepToBits(empty, 2))
+          + __builtin_popcount(getMoversFromBoard<player, 3>(board) & stepToBits(empty, 3));
+}
+
+
+// appends the simple moves of a player in a direction
+template<unsigned short player, int direction>
+static inline void addStepsToMoveList(Checkers::Board const& board, uint32_t empty, Checkers::MoveList& moveList) {
+    uint32_t bits, movers = getMoversFromBoard<player, direction>(board) & stepToBits(empty, direction);
+    int i;
+
+    for(i = 0; i < 2; i++) {
+        for(bits = movers & rowMasks[i]; bits; bits &= bits - 1) {
+            Checkers::Move& move = moveList.moves[moveList.size++];
+
+            move.from = __builtin_ctz(bits);
+            move.to = move.from + stepOffsets[i][direction];
+            move.captures = 0;
+            move.player = player;
+        }
+    }
+}
+
+
+// the moves of a player, with the player fixed at compile time (the forward directions of its regular pieces are constants)
+template<unsigned short player>
+static void getMovesFromBoard(Checkers::Board const& board, Checkers::MoveList& moveList) {
+    int j, direction;
+    Checkers::Move tempMove;
+    uint8_t firstMove;            // first move recorded for the current piece
+    struct {
+        uint32_t square;          // bit of the current square
+        uint8_t index;            // the current square
+        uint32_t jumped;          // bit of the piece jumped to reach the current square
+        uint8_t checked;          // variable for checking jump directions
+        bool descJump;            // one of the descendants made a jump (this way, we don't record invalid jumps)
+    } boardStack[13], node;
+    uint32_t pieceJumped = 0;     // mask describing which pieces were jumped
+    uint32_t empty = ~(board.pieces[0] | board.pieces[1]);
+    uint32_t opponentPieces = board.pieces[(~player) & 1];
+    uint32_t bits;
+    uint8_t directions;           // directions the current piece may move in
+    uint8_t depth;                // current depth of the move stack
+
+    tempMove.player = player;
+    moveList.size = 0;
+
+    // first, check for jumps (only pieces with an enemy piece and an empty square behind it can start one)
+    for(bits = getJumpersFromBoard<player>(board); bits; bits &= bits - 1) {
+        boardStack[0].square = bits & -bits;
+        boardStack[0].index = __builtin_ctz(bits);
+        boardStack[0].checked = 0;
+        tempMove.from = boardStack[0].index;
+        firstMove = moveList.size;
+        directions = (board.kings & boardStack[0].square) ? 0xFU : manDirections[player];
+        depth = 0;
+
+        while(boardStack[0].checked != directions || depth != 0) {
+            node = boardStack[depth];
+
+            // check the next unchecked direction
+            if(node.checked != directions) {
+                direction = __builtin_ctz(directions & ~node.checked);
+                boardStack[depth].checked |= 1U << direction;
+
+                // an off-board jump has no bits in the tables
+                if(    (squareTables::stepBits[node.index][direction] & opponentPieces & ~pieceJumped)           // jump square holds unjumped enemy piece
+                    && (squareTables::jumpBits[node.index][direction] & (empty | boardStack[0].square))) {      // dest square empty OR same as start square
+
+                    depth++;
+                    boardStack[depth].square = squareTables::jumpBits[node.index][direction];
+                    boardStack[depth].index = __builtin_ctz(boardStack[depth].square);
+                    boardStack[depth].jumped = squareTables::stepBits[node.index][direction];
+                    boardStack[depth].checked = 0;
+                    boardStack[depth].descJump = false;
+                    pieceJumped |= boardStack[depth].jumped; // we have jumped that piece
+                }
+            }
+
+            // everything has been checked already
+            // as long as our desc (if any) didn't make a jump, we should count the stack as a jump move
+            else {
+                if(!node.descJump) {
+                    tempMove.to = __builtin_ctz(node.square);
+                    tempMove.captures = pieceJumped;
+
+                    // a king may jump the same pieces in a different order; that is the same move
+                    for(j = firstMove; j < moveList.size; j++) {
+                        if(moveList.moves[j].to == tempMove.to && moveList.moves[j].captures == tempMove.captures) {
+                            break;
+                        }
+                    }
+                    if(j == moveList.size) {
+                        // dropping a move would make the list wrong, so running out of room is fatal
+                        if(moveList.size == Checkers::maxMoves) {
+                            std::cerr << "Error: a position has more than " << Checkers::maxMoves << " jump moves" << std::endl;
+                            std::abort();
+                        }
+                        moveList.moves[moveList.size++] = tempMove;
+                    }
+                }
+
+                // if we're in here, a desc of our parent definitely made a jump
+                boardStack[depth - 1].descJump = true;
+
+                // remove jumped piece status
+                pieceJumped &= ~node.jumped;
+
+                depth--; // go up one
+            }
+        }
+    }
+
+    // if no jumps were found, look for simple moves
+    if(!moveList.size) {
+        addStepsToMoveList<player, 0>(board, empty, moveList);
+        addStepsToMoveList<player, 1>(board, empty, moveList);
+        addStepsToMoveList<player, 2>(board, empty, moveList);
+        addStepsToMoveList<player, 3>(board, empty, moveList);
+    }
+}
+
+
+// Zobrist keys for the pieces of each player, the kings, and Player 2 to move
+static struct ZobristKeys {
+    uint64_t pieces[2][32];
+    uint64_t kings[32];
+    uint64_t playerTurn;
+
+    ZobristKeys() {
+        uint64_t seed = 0x2545F4914F6CDD1DULL;
+        int i, j;
+
+        for(i = 0; i < 2; i++) {
+            for(j = 0; j < 32; j++) {
+                this->pieces[i][j] = this->next(seed);
+            }
+        }
+        for(j = 0; j < 32; j++) {
+            this->kings[j] = this->next(seed);
+        }
+        this->playerTurn = this->next(seed);
+    }
+
+    // splitmix64, so the keys are the same on every run
+    static uint64_t next(uint64_t& seed) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+} zobristKeys;
+
+
+// tablebase wins outscore any evaluation, but not the INT_MAX of a finished game
+static const int tablebaseWinScore = 1 << 24;
+
+
+// half width of the first aspiration window around the score of the previous iteration
+static const int aspirationWindow = 300;
+
+
+static inline void setMovePath(Checkers::MovePath& move, int i, int square) {
+    move.yPath[i] = square >> 2;
+    move.xPath[i] = ((square & 3) << 1) | (move.yPath[i] & 1);
+}
+//////////////////////////////////////
+// END  Bitboard helper definitions //
+//////////////////////////////////////
+
+
+
+//////////////////////////////////////////
+// BEGIN  Evaluation kernel definitions //
+//////////////////////////////////////////
+// vector versions of the neighbour terms and the win conditions of evaluateBoard, one board per 32-bit
+// lane; each kernel returns the number of boards it scored (all of them)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHECKERS_X86_KERNELS
+#endif
+
+#if defined(CHECKERS_X86_KERNELS) && defined(__SSE2__)
+static inline __m128i shiftBitsSSE2(__m128i bits, int offset) {
+    return offset > 0 ? _mm_sll_epi32(bits, _mm_cvtsi32_si128(offset)) : _mm_srl_epi32(bits, _mm_cvtsi32_si128(-offset));
+}
+
+
+static inline __m128i stepToBitsSSE2(__m128i bits, int direction) {
+    return _mm_and_si128(  _mm_set1_epi32(stepMasks[direction])
+                         , _mm_or_si128(  _mm_and_si128(_mm_set1_epi32(rowMasks[0]), shiftBitsSSE2(bits, -stepOffsets[0][direction]))
+                                        , _mm_and_si128(_mm_set1_epi32(rowMasks[1]), shiftBitsSSE2(bits, -stepOffsets[1][direction]))));
+}
+
+
+static inline __m128i popcountSSE2(__m128i bits) {
+    bits = _mm_sub_epi32(bits, _mm_and_si128(_mm_srli_epi32(bits, 1), _mm_set1_epi32(0x55555555)));
+    bits = _mm_add_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x33333333)), _mm_and_si128(_mm_srli_epi32(bits, 2), _mm_set1_epi32(0x33333333)));
+    bits = _mm_and_si128(_mm_add_epi32(bits, _mm_srli_epi32(bits, 4)), _mm_set1_epi32(0x0F0F0F0F));
+    bits = _mm_add_epi32(bits, _mm_srli_epi32(bits, 8));
+    bits = _mm_add_epi32(bits, _mm_srli_epi32(bits, 16));
+    return _mm_and_si128(bits, _mm_set1_epi32(0x3F));
+}
+
+
+// the counts fit in 16 bits, so multiplying the low halves of the lanes (and the zero high halves by 0) is enough
+static inline __m128i multiplySSE2(__m128i counts, int factor) {
+    return _mm_madd_epi16(counts, _mm_set1_epi32(factor));
+}
+
+
+static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+
+static inline __m128i evaluateBoardsSSE2(__m128i const * pieces, __m128i kings, __m128i pieceSquareScores, uint8_t me) {
+    __m128i empty, men, movers, movable, score[2], noMove[2], result;
+    int i, direction;
+
+    empty = _mm_andnot_si128(_mm_or_si128(pieces[0], pieces[1]), _mm_set1_epi32(-1));
+
+    for(i = 0; i < 2; i++) {
+        men = _mm_andnot_si128(kings, pieces[i]);
+
+        // protected regular pieces, and regular pieces challenging an enemy piece
+        score[i] = _mm_add_epi32(  popcountSSE2(_mm_and_si128(men, stepToBitsSSE2(pieces[i], 2 - 2 * i)))
+                                 , popcountSSE2(_mm_and_si128(men, stepToBitsSSE2(pieces[i], 3 - 2 * i))));
+        score[i] = _mm_add_epi32(  multiplySSE2(score[i], 150)
+                                 , multiplySSE2(popcountSSE2(_mm_and_si128(  _mm_andnot_si128(_mm_set1_epi32(backRanks[i]), men)
+                                                                           , shiftBitsSSE2(pieces[~i & 1], 16 * i - 8))), 100));
+
+        // pieces able to jump or step
+        movable = _mm_setzero_si128();
+        for(direction = 0; direction < 4; direction++) {
+            movers = (manDirections[i] >> direction) & 1 ? pieces[i] : _mm_and_si128(pieces[i], kings);
+            movable = _mm_or_si128(movable, _mm_and_si128(movers, stepToBitsSSE2(empty, direction)));
+            movable = _mm_or_si128(movable, _mm_and_si128(  _mm_and_si128(movers, _mm_set1_epi32(jumpMasks[direction]))
+                                                          , _mm_and_si128(  stepToBitsSSE2(pieces[~i & 1], direction)
+                                                                          , shiftBitsSSE2(empty, -jumpOffsets[direction]))));
+        }
+        noMove[i] = _mm_cmpeq_epi32(movable, _mm_setzero_si128());
+    }
+
+    result = _mm_add_epi32(_mm_sub_epi32(score[0], score[1]), pieceSquareScores);
+    if(me) {
+        result = _mm_sub_epi32(_mm_setzero_si128(), result);
+    }
+
+    // the win conditions, from the last checked by evaluateBoard to the first, so the first one met wins
+    result = selectSSE2(noMove[~me & 1], _mm_set1_epi32(INT_MAX), result);
+    result = selectSSE2(noMove[me], _mm_set1_epi32(INT_MIN), result);
+    result = selectSSE2(_mm_cmpeq_epi32(pieces[~me & 1], _mm_setzero_si128()), _mm_set1_epi32(INT_MAX), result);
+    result = selectSSE2(_mm_cmpeq_epi32(pieces[me], _mm_setzero_si128()), _mm_set1_epi32(INT_MIN), result);
+
+    return result;
+}
+
+
+// the boards left over after the whole vectors are copied into a vector padded with empty boards
+static int evaluateBlockSSE2(Checkers::EvaluationBlock const& block, uint8_t me, int * scores) {
+    __m128i pieces[2];
+    uint32_t rest[4][4];
+    int32_t restScores[4];
+    int i, n;
+
+    for(n = 0; n + 4 <= block.size; n += 4) {
+        pieces[0] = _mm_loadu_si128((__m128i const *) &block.pieces[0][n]);
+        pieces[1] = _mm_loadu_si128((__m128i const *) &block.pieces[1][n]);
+        _mm_storeu_si128((__m128i *) &scores[n], evaluateBoardsSSE2(  pieces
+                                                                    , _mm_loadu_si128((__m128i const *) &block.kings[n])
+                                                                    , _mm_loadu_si128((__m128i const *) &block.pieceSquareScores[n])
+                                                                    , me));
+    }
+
+    if(n < block.size) {
+        std::fill(&rest[0][0], &rest[0][0] + 4 * 4, 0);
+        for(i = n; i < block.size; i++) {
+            rest[0][i - n] = block.pieces[0][i];
+            rest[1][i - n] = block.pieces[1][i];
+            rest[2][i - n] = block.kings[i];
+            rest[3][i - n] = block.pieceSquareScores[i];
+        }
+
+        pieces[0] = _mm_loadu_si128((__m128i const *) rest[0]);
+        pieces[1] = _mm_loadu_si128((__m128i const *) rest[1]);
+        _mm_storeu_si128((__m128i *) restScores, evaluateBoardsSSE2(  pieces
+                                                                    , _mm_loadu_si128((__m128i const *) rest[2])
+                                                                    , _mm_loadu_si128((__m128i const *) rest[3])
+                                                                    , me));
+        std::copy(restScores, restScores + block.size - n, scores + n);
+    }
+
+    return block.size;
+}
+#endif
+
+#ifdef CHECKERS_X86_KERNELS
+#define CHECKERS_AVX2 __attribute__((target("avx2")))
+
+CHECKERS_AVX2 static inline __m256i shiftBitsAVX2(__m256i bits, int offset) {
+    return offset > 0 ? _mm256_sll_epi32(bits, _mm_cvtsi32_si128(offset)) : _mm256_srl_epi32(bits, _mm_cvtsi32_si128(-offset));
+}
+
+
+CHECKERS_AVX2 static inline __m256i stepToBitsAVX2(__m256i bits, int direction) {
+    return _mm256_and_si256(  _mm256_set1_epi32(stepMasks[direction])
+                            , _mm256_or_si256(  _mm256_and_si256(_mm256_set1_epi32(rowMasks[0]), shiftBitsAVX2(bits, -stepOffsets[0][direction]))
+                                              , _mm256_and_si256(_mm256_set1_epi32(rowMasks[1]), shiftBitsAVX2(bits, -stepOffsets[1][direction]))));
+}
+
+
+// bit counts of the nibbles looked up with a byte shuffle, then summed over the bytes of each lane
+CHECKERS_AVX2 static inline __m256i popcountAVX2(__m256i bits) {
+    const __m256i nibbleCounts = _mm256_setr_epi8(  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+                                                  , 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i counts = _mm256_add_epi8(  _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(bits, lowNibbles))
+                                     , _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi32(bits, 4), lowNibbles)));
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(counts, _mm256_set1_epi8(1)), _mm256_set1_epi16(1));
+}
+
+
+CHECKERS_AVX2 static inline __m256i evaluateBoardsAVX2(__m256i const * pieces, __m256i kings, __m256i pieceSquareScores, uint8_t me) {
+    __m256i empty, men, movers, movable, score[2], noMove[2], result;
+    int i, direction;
+
+    empty = _mm256_andnot_si256(_mm256_or_si256(pieces[0], pieces[1]), _mm256_set1_epi32(-1));
+
+    for(i = 0; i < 2; i++) {
+        men = _mm256_andnot_si256(kings, pieces[i]);
+
+        // protected regular pieces, and regular pieces challenging an enemy piece
+        score[i] = _mm256_add_epi32(  popcountAVX2(_mm256_and_si256(men, stepToBitsAVX2(pieces[i], 2 - 2 * i)))
+                                    , popcountAVX2(_mm256_and_si256(men, stepToBitsAVX2(pieces[i], 3 - 2 * i))));
+        score[i] = _mm256_add_epi32(  _mm256_mullo_epi32(score[i], _mm256_set1_epi32(150))
+                                    , _mm256_mullo_epi32(popcountAVX2(_mm256_and_si256(  _mm256_andnot_si256(_mm256_set1_epi32(backRanks[i]), men)
+                                                                                       , shiftBitsAVX2(pieces[~i & 1], 16 * i - 8)))
+                                                         , _mm256_set1_epi32(100)));
+
+        // pieces able to jump or step
+        movable = _mm256_setzero_si256();
+        for(direction = 0; direction < 4; direction++) {
+            movers = (manDirections[i] >> direction) & 1 ? pieces[i] : _mm256_and_si256(pieces[i], kings);
+            movable = _mm256_or_si256(movable, _mm256_and_si256(movers, stepToBitsAVX2(empty, direction)));
+            movable = _mm256_or_si256(movable, _mm256_and_si256(  _mm256_and_si256(movers, _mm256_set1_epi32(jumpMasks[direction]))
+                                                                , _mm256_and_si256(  stepToBitsAVX2(pieces[~i & 1], direction)
+                                                                                   , shiftBitsAVX2(empty, -jumpOffsets[direction]))));
+        }
+        noMove[i] = _mm256_cmpeq_epi32(movable, _mm256_setzero_si256());
+    }
+
+    result = _mm256_add_epi32(_mm256_sub_epi32(score[0], score[1]), pieceSquareScores);
+    if(me) {
+        result = _mm256_sub_epi32(_mm256_setzero_si256(), result);
+    }
+
+    // the win conditions, from the last checked by evaluateBoard to the first, so the first one met wins
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(INT_MAX), noMove[~me & 1]);
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(INT_MIN), noMove[me]);
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(INT_MAX), _mm256_cmpeq_epi32(pieces[~me & 1], _mm256_setzero_si256()));
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(INT_MIN), _mm256_cmpeq_epi32(pieces[me], _mm256_setzero_si256()));
+
+    return result;
+}
+
+
+// the boards left over after the whole vectors are copied into a vector padded with empty boards
+CHECKERS_AVX2 static int evaluateBlockAVX2(Checkers::EvaluationBlock const& block, uint8_t me, int * scores) {
+    __m256i pieces[2];
+    uint32_t rest[4][8];
+    int32_t restScores[8];
+    int i, n;
+
+    for(n = 0; n + 8 <= block.size; n += 8) {
+        pieces[0] = _mm256_loadu_si256((__m256i const *) &block.pieces[0][n]);
+        pieces[1] = _mm256_loadu_si256((__m256i const *) &block.pieces[1][n]);
+        _mm256_storeu_si256((__m256i *) &scores[n], evaluateBoardsAVX2(  pieces
+                                                                       , _mm256_loadu_si256((__m256i const *) &block.kings[n])
+                                                                       , _mm256_loadu_si256((__m256i const *) &block.pieceSquareScores[n])
+                                                                       , me));
+    }
+
+    if(n < block.size) {
+        std::fill(&rest[0][0], &rest[0][0] + 4 * 8, 0);
+        for(i = n; i < block.size; i++) {
+            rest[0][i - n] = block.pieces[0][i];
+            rest[1][i - n] = block.pieces[1][i];
+            rest[2][i - n] = block.kings[i];
+            rest[3][i - n] = block.pieceSquareScores[i];
+        }
+
+        pieces[0] = _mm256_loadu_si256((__m256i const *) rest[0]);
+        pieces[1] = _mm256_loadu_si256((__m256i const *) rest[1]);
+        _mm256_storeu_si256((__m256i *) restScores, evaluateBoardsAVX2(  pieces
+                                                                       , _mm256_loadu_si256((__m256i const *) rest[2])
+                                                                       , _mm256_loadu_si256((__m256i const *) rest[3])
+                                                                       , me));
+        std::copy(restScores, restScores + block.size - n, scores + n);
+    }
+
+    return block.size;
+}
+#endif
+////////////////////////////////////////
+// END  Evaluation kernel definitions //
+////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// BEGIN  TranspositionTable method definitions (in order of appearance in checkers.hpp) //
+///////////////////////////////////////////////////////////////////////////////////////////
+Checkers::TranspositionTable::TranspositionTable() {
+    this->mask = 0;
+    this->generation = 0;
+}
+
+
+void Checkers::TranspositionTable::resize(unsigned int megabytes) {
+    uint64_t numSlots = 1;
+
+    // use the largest power of two number of slots that fits, so keys can be masked into an index
+    while(2 * numSlots * sizeof(Slot) <= uint64_t(megabytes) << 20) {
+        numSlots *= 2;
+    }
+
+    if(numSlots != this->slots.size()) {
+        this->slots.resize(numSlots);
+        this->mask = numSlots - 1;
+        this->clear();
+    }
+}
+
+
+void Checkers::TranspositionTable::clear() {
+    Slot empty;
+
+    // an all-zero slot only verifies for key 0, which no position hashes to in practice
+    empty.check = empty.data = 0;
+
+    std::fill(this->slots.begin(), this->slots.end(), empty);
+    this->generation = 0;
+}
+
+
+void Checkers::TranspositionTable::newSearch() {
+    this->generation++;
+}
+
+
+// data layout: score (bits 0-31), depth (32-39), bound (40-47), move index (48-55), generation (56-63)
+bool Checkers::TranspositionTable::probe(uint64_t key, Checkers::TableEntry& entry) {
+    Slot * slot;
+    uint64_t data;
+
+    if(this->slots.empty()) {
+        return false;
+    }
+
+    slot = &this->slots[key & this->mask];
+    data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+
+    if((__atomic_load_n(&slot->check, __ATOMIC_RELAXED) ^ data) != key) {
+        return false;
+    }
+
+    entry.key = key;
+    entry.score = int32_t(uint32_t(data));
+    entry.depth = uint8_t(data >> 32);
+    entry.bound = uint8_t(data >> 40);
+    entry.moveIndex = uint8_t(data >> 48);
+    entry.generation = uint8_t(data >> 56);
+
+    return true;
+}
+
+
+void Checkers::TranspositionTable::store(uint64_t key, uint8_t depth, uint8_t bound, int score, uint8_t moveIndex) {
+    Slot * slot;
+    uint64_t data, slotData;
+    bool sameKey;
+
+    if(this->slots.empty()) {
+        return;
+    }
+
+    slot = &this->slots[key & this->mask];
+    slotData = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+    sameKey = (__atomic_load_n(&slot->check, __ATOMIC_RELAXED) ^ slotData) == key;
+
+    // keep deeper results for the same search, but always replace results of older searches
+    if(sameKey || uint8_t(slotData >> 56) != this->generation || depth >= uint8_t(slotData >> 32)) {
+        // keep the best move of a position which is searched again without finding one
+        if(sameKey && moveIndex == 0xFFU) {
+            moveIndex = uint8_t(slotData >> 48);
+        }
+
+        data =   uint64_t(uint32_t(score))
+               | (uint64_t(depth) << 32)
+               | (uint64_t(bound) << 40)
+               | (uint64_t(moveIndex) << 48)
+               | (uint64_t(this->generation) << 56);
+
+        __atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->check, key ^ data, __ATOMIC_RELAXED);
+    }
+}
+////////////////////////////////////////////////
+// END  TranspositionTable method definitions //
+////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////////////////////////////
+// BEGIN  TimeManager method definitions (in order of appearance in checkers.hpp) //
+////////////////////////////////////////////////////////////////////////////////////
+Checkers::TimeManager::TimeManager() {
+    this->moveTime = 0;
+    this->gameTimeRemaining = -1;
+    this->gameTimeIncrement = 0;
+    this->softLimit = 0;
+    this->hardLimit = 0;
+}
+
+
+void Checkers::TimeManager::setMoveTime(double moveTime) {
+    this->moveTime = moveTime;
+    this->gameTimeRemaining = -1;
+    this->gameTimeIncrement = 0;
+}
+
+
+void Checkers::TimeManager::setGameTime(double timeRemaining, double timeIncrement) {
+    this->gameTimeRemaining = timeRemaining;
+    this->gameTimeIncrement = timeIncrement;
+}
+
+
+// with a clock, a move gets its share of the time left and most of the increment, and may run up to
+// four times over it to finish an iteration; both limits keep a margin for making the move
+void Checkers::TimeManager::allocateMoveTime() {
+    if(this->gameTimeRemaining < 0) {
+        this->softLimit = this->hardLimit = this->moveTime - Checkers::timeRemainingThreshold;
+        return;
+    }
+
+    this->softLimit = this->gameTimeRemaining / Checkers::movesToGo + 0.75 * this->gameTimeIncrement;
+    this->hardLimit = std::min(4 * this->softLimit, this->gameTimeRemaining / 2) - Checkers::timeRemainingThreshold;
+    this->softLimit = std::min(this->softLimit, this->hardLimit);
+}
+
+
+double Checkers::TimeManager::getHardLimit() {
+    return this->hardLimit;
+}
+
+
+// the next iteration is expected to take as many times longer than the last one as the last one did
+// than the one before (the observed branching factor, kept to a sane range for the short first ones)
+bool Checkers::TimeManager::canStartIteration(double secondsElapsed, double iterationSeconds, double previousIterationSeconds) {
+    double branchingFactor = previousIterationSeconds > 0 ? iterationSeconds / previousIterationSeconds : 2;
+
+    branchingFactor = std::min(std::max(branchingFactor, 1.0), 10.0);
+
+    return secondsElapsed < this->softLimit && secondsElapsed + branchingFactor * iterationSeconds < this->hardLimit;
+}
+/////////////////////////////////////////
+// END  TimeManager method definitions //
+/////////////////////////////////////////
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // BEGIN  Player method definitions (in order of appearance in checkers.hpp) //
 ///////////////////////////////////////////////////////////////////////////////
@@ -55,160 +793,871 @@ Checkers::Player::Player() {
     this->isComputer = false;
     this->previousMoveTime = Duration::zero();
     this->totalMoveTime = Duration::zero();
-    this->timeLimit = 0;
     this->maxDepthReached = 0;
+    this->depthLimit = 49;
+    this->nodeLimit = 0;
+    this->threadCount = Checkers::searchThreads;
+    this->stopRequest = std::make_shared<std::atomic<bool> >(false);
+    this->searchPlayer = 0;
+    this->searchStartTime = Clock::now();
+    this->ponder = false;
+}
+
+
+Checkers::Player::Player(Checkers::Game * game, bool isComputer, double timeLimit)
+    : Checkers::Player::Player(game, isComputer, timeLimit, true) {
+}
+
+
+// players which search for reproducible node counts (the bench) do without the files, which are
+// built locally and change the search
+Checkers::Player::Player(Checkers::Game * game, bool isComputer, double timeLimit, bool useFiles) {
+    this->game = game;
+    this->isComputer = isComputer;
+    this->previousMoveTime = Duration::zero();
+    this->totalMoveTime = Duration::zero();
+    this->timeManager.setMoveTime(timeLimit);
+    this->maxDepthReached = 0;
+    this->depthLimit = 49;
+    this->nodeLimit = 0;
+    this->threadCount = Checkers::searchThreads;
+    this->stopRequest = std::make_shared<std::atomic<bool> >(false);
+    this->searchPlayer = 0;
+    this->searchStartTime = Clock::now();
+    this->ponder = false;
+
+    // the search goes without the tablebase or the book if they have not been generated
+    if(isComputer && useFiles) {
+        this->tablebase.open(Checkers::tablebaseFilePath);
+        this->book.open(Checkers::openingBookFilePath);
+    }
+}
+
+
+Checkers::Move Checkers::Player::makeMove(Checkers::Board const& board) {
+    Checkers::Move move;
+    std::vector<Checkers::Move> moveList;
+    std::string playerAction;
+    std::string savedGameFilePath;
+    bool playerMoved, ponderHit;
+    uint8_t i;
+
+    // computer
+    if(this->isComputer) {
+        moveList = this->game->getMovesFromBoard_andPlayer(board, this->game->getPlayerTurn());
+
+        // the search on the opponent's time is only of use if they played the expected reply
+        ponderHit =    this->ponderSearch && moveList.size() > 1
+                    && this->ponderSearch->board.pieces[0] == board.pieces[0]
+                    && this->ponderSearch->board.pieces[1] == board.pieces[1]
+                    && this->ponderSearch->board.kings == board.kings;
+        if(!ponderHit) {
+            this->stopPondering();
+        }
+
+        if(!moveList.size()) {
+            move.player = this->game->getPlayerTurn();
+            move.from = move.to = 0xFFU;
+            move.captures = 0;
+            playerMoved = true;
+            this->game->stop();
+        }
+
+        else if(moveList.size() == 1) {
+            move = moveList[0];
+            this->maxDepthReached = 0;
+        }
+
+        // the ponder search goes on, now under the clock of this move (before the book, which would
+        // otherwise leave it running)
+        else if(ponderHit) {
+            this->searchStartTime = this->game->getMoveStartTime();
+            this->ponderSearch->active = false;
+            this->ponderSearch->thread.join();
+            move = this->ponderSearch->move;
+            this->maxDepthReached = this->ponderSearch->maxDepthReached;
+            this->ponderSearch.reset();
+        }
+
+        // book moves save the clock for later in the game
+        else if(this->book.probe(board, this->game->getPlayerTurn(), move)) {
+            this->maxDepthReached = 0;
+        }
+
+        else {
+            //move = moveList[std::rand() & (moveList.size() - 1)]; // pick randomly
+            move = this->pickMoveFromBoard(board); // pick using alpha beta
+        }
+
+        if(this->ponder && move.from <= 31) {
+            this->startPondering(board, move);
+        }
+    }
+
+    // human
+    else {
+        playerMoved = false;
+
+        // get possible moves
+        moveList = this->game->getMovesFromBoard_andPlayer(board, this->game->getPlayerTurn());
+
+        // if there are no possible moves, end the game
+        if(!moveList.size()) {
+            move.player = this->game->getPlayerTurn();
+            move.from = move.to = 0xFFU;
+            move.captures = 0;
+            playerMoved = true;
+            this->game->stop();
+        }
+
+        while(!playerMoved) {
+            for(i = 0; i < moveList.size(); i++) {
+                std::cout << "  [" << (i + 1) << "]  " << this->game->parseMove(moveList[i]) << std::endl;
+            }
+            std::cout << "  [S]  Save game" << std::endl;
+            std::cout << "  [Q]  Forfeit game" << std::endl;
+            
+            while((std::cout << "Please select an action: ")
+                    && (!(std::cin >> playerAction)
+                        || (   (playerAction.c_str()[0] != 'S' && playerAction.c_str()[0] != 's')
+                            && (playerAction.c_str()[0] != 'Q' && playerAction.c_str()[0] != 'q')
+                            && ((uint8_t) std::strtoll(playerAction.c_str(), nullptr, 10) < 1
+                                || (uint8_t) std::strtoll(playerAction.c_str(), nullptr, 10) > moveList.size())))) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+            
+            if(playerAction.c_str()[0] == 'S' || playerAction.c_str()[0] == 's') {
+                std::cout << "Please enter a saved game file path: ";
+                std::cin >> savedGameFilePath;
+                this->game->save(savedGameFilePath);
+            } else if(playerAction.c_str()[0] == 'Q' || playerAction.c_str()[0] == 'q') {
+                move.player = this->game->getPlayerTurn();
+                move.from = move.to = 0xFFU;
+                move.captures = 0;
+                playerMoved = true;
+                std::cout << "Quitting game ..." << std::endl;
+                this->game->stop();
+            } else {
+                move = moveList[std::strtoll(playerAction.c_str(), nullptr, 10) - 1];
+                playerMoved = true;
+            }
+        }
+    }
+
+    return move;
+}
+
+
+Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board) {
+    Checkers::Move move;
+
+    this->searchStartTime = this->game->getMoveStartTime();
+    this->keyHistory = this->game->getKeyHistory();
+    move = this->pickMoveFromBoard_andPlayer(board, this->game->getPlayerTurn());
+    this->maxDepthReached = this->threads[0].maxDepthReached;
+
+    return move;
+}
+
+
+int Checkers::Player::evaluateBoard(Board const& board) {
+    return this->evaluateBoard(board, Checkers::Player::getPieceSquareScoreFromBoard(board));
+}
+
+
+// the piece-square terms (material, center control, advancement, back rank) come in with
+// pieceSquareScore; only the terms depending on neighbouring pieces are computed here
+int Checkers::Player::evaluateBoard(Board const& board, int pieceSquareScore) {
+    int i;
+    int score[2] = {0};
+    int pieceCount[2] = {0};
+    uint8_t me = this->searchPlayer;
+    uint8_t opponent = ~me & 1;
+
+    // challenge empty squares attacked by the enemy pieces
+    // control the sides
+
+    // track each player's piece counts (for checking for win conditions)
+    for(i = 0; i < 2; i++) {
+        pieceCount[i] = __builtin_popcount(board.pieces[i]);
+    }
+
+    // protect regular pieces (own pieces on the squares behind) and challenge enemy pieces (two squares straight ahead)
+    score[0] = getNeighbourScoreFromBoard<0>(board);
+    score[1] = getNeighbourScoreFromBoard<1>(board);
+
+    // I have no more pieces => loss
+    if(!pieceCount[me]) {
+        return INT_MIN;
+    }
+
+    // opponent has no more pieces => win
+    if(!pieceCount[opponent]) {
+        return INT_MAX;
+    }
+
+    // I have no more moves => loss
+    if(!Checkers::Game::hasMoveFromBoard_andPlayer(board, me)) {
+        return INT_MIN;
+    }
+
+    // opponent has no more moves => win
+    if(!Checkers::Game::hasMoveFromBoard_andPlayer(board, opponent)) {
+        return INT_MAX;
+    }
+
+    // no clear win conditions met, we just return the score difference
+    return score[me] - score[opponent] + (me ? -pieceSquareScore : pieceSquareScore);
+}
+
+
+void Checkers::Player::setSearchPlayer(uint8_t player) {
+    this->searchPlayer = player;
+}
+
+
+void Checkers::Player::evaluateBlock(Checkers::EvaluationBlock const& block, int * scores) {
+    this->evaluateBlock(  block
+                        , scores
+                        , Checkers::Player::isEvaluationKernelSupported(Checkers::avx2Kernel) ? Checkers::avx2Kernel : Checkers::sse2Kernel);
+}
+
+
+// an unsupported kernel falls back on the scalar one
+void Checkers::Player::evaluateBlock(Checkers::EvaluationBlock const& block, int * scores, Checkers::EvaluationKernel kernel) {
+    Checkers::Board board;
+    int n = 0;
+
+    if(!Checkers::Player::isEvaluationKernelSupported(kernel)) {
+        kernel = Checkers::scalarKernel;
+    }
+
+#ifdef CHECKERS_X86_KERNELS
+    if(kernel == Checkers::avx2Kernel) {
+        n = evaluateBlockAVX2(block, this->searchPlayer, scores);
+    }
+#endif
+#if defined(CHECKERS_X86_KERNELS) && defined(__SSE2__)
+    if(kernel == Checkers::sse2Kernel) {
+        n = evaluateBlockSSE2(block, this->searchPlayer, scores);
+    }
+#endif
+
+    for(; n < block.size; n++) {
+        board.pieces[0] = block.pieces[0][n];
+        board.pieces[1] = block.pieces[1][n];
+        board.kings = block.kings[n];
+        scores[n] = this->evaluateBoard(board, block.pieceSquareScores[n]);
+    }
+}
+
+
+bool Checkers::Player::isEvaluationKernelSupported(Checkers::EvaluationKernel kernel) {
+    switch(kernel) {
+#if defined(CHECKERS_X86_KERNELS) && defined(__SSE2__)
+        case Checkers::sse2Kernel:
+            return true;
+#endif
+#ifdef CHECKERS_X86_KERNELS
+        case Checkers::avx2Kernel:
+            return __builtin_cpu_supports("avx2");
+#endif
+        case Checkers::scalarKernel:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+Checkers::SearchResult Checkers::Player::search(Checkers::Board const& board, uint8_t player, Checkers::SearchLimits const& limits) {
+    return this->search(board, player, limits, std::vector<uint64_t>());
+}
+
+
+// the limits replace those of the game's player; the search is timed from the call
+Checkers::SearchResult Checkers::Player::search(  Checkers::Board const& board
+                                                , uint8_t player
+                                                , Checkers::SearchLimits const& limits
+                                                , std::vector<uint64_t> const& keyHistory) {
+    Checkers::SearchResult result;
+    Checkers::Time timeInitial = Checkers::Clock::now();
+
+    this->timeManager.setMoveTime(limits.timeLimit);
+    this->setDepthLimit(limits.depthLimit);
+    this->nodeLimit = limits.nodeLimit;
+    this->threadCount = limits.threads ? limits.threads : Checkers::searchThreads;
+
+    result.info.depth = 0;
+    result.info.score = 0;
+    result.info.nodes = 0;
+    result.info.seconds = 0;
+
+    if(!Checkers::Game::hasMoveFromBoard_andPlayer(board, player)) {
+        result.move.player = player;
+        result.move.from = result.move.to = 0xFFU;
+        result.move.captures = 0;
+        return result;
+    }
+
+    this->searchStartTime = timeInitial;
+    this->keyHistory = keyHistory;
+    result.move = this->pickMoveFromBoard_andPlayer(board, player);
+    this->maxDepthReached = this->threads[0].maxDepthReached;
+
+    result.info.depth = this->maxDepthReached;
+    result.info.score = this->threads[0].score;
+    result.info.nodes = this->getNodeCount();
+    result.info.seconds = std::chrono::duration<double>(Checkers::Clock::now() - timeInitial).count();
+    result.info.principalVariation = this->getPrincipalVariation(board, result.move, this->maxDepthReached);
+
+    return result;
+}
+
+
+int Checkers::Player::getPieceSquareScoreFromBoard(Board const& board) {
+    int score = 0;
+    uint32_t bits;
+
+    for(bits = board.pieces[0]; bits; bits &= bits - 1) {
+        score += squareTables::pieceSquareValues[0][(board.kings >> __builtin_ctz(bits)) & 1][__builtin_ctz(bits)];
+    }
+    for(bits = board.pieces[1]; bits; bits &= bits - 1) {
+        score -= squareTables::pieceSquareValues[1][(board.kings >> __builtin_ctz(bits)) & 1][__builtin_ctz(bits)];
+    }
+
+    return score;
+}
+
+
+// only the moved piece and the captured pieces change the score
+int Checkers::Player::getNextPieceSquareScoreFromMoveUndo(int score, MoveUndo const& undo) {
+    int sign = undo.player ? -1 : 1;
+    uint8_t opponent = (~undo.player) & 1;
+    uint32_t bits;
+
+    score -= sign * squareTables::pieceSquareValues[undo.player][undo.wasKing][undo.from];
+    score += sign * squareTables::pieceSquareValues[undo.player][undo.wasKing || undo.promoted][undo.to];
+
+    for(bits = undo.captured; bits; bits &= bits - 1) {
+        score += sign * squareTables::pieceSquareValues[opponent][(undo.capturedKings >> __builtin_ctz(bits)) & 1][__builtin_ctz(bits)];
+    }
+
+    return score;
+}
+
+
+void Checkers::Player::addMadeMove(Checkers::Move const& move) {
+    this->moveList.push_back(move);
+}
+
+
+void Checkers::Player::addTotalMoveTime(Checkers::Duration const& moveTime) {
+    this->totalMoveTime += moveTime;
+}
+
+
+void Checkers::Player::setPreviousMoveTime(Checkers::Duration const& moveTime) {
+    this->previousMoveTime = moveTime;
 }
 
 
-Checkers::Player::Player(Checkers::Game * game, bool isComputer, double timeLimit) {
-    this->game = game;
-    this->isComputer = isComputer;
-    this->previousMoveTime = Duration::zero();
-    this->totalMoveTime = Duration::zero();
-    this->timeLimit = timeLimit;
-    this->maxDepthReached = 0;
+Checkers::Duration Checkers::Player::getTotalMoveTime() {
+    return this->totalMoveTime;
 }
 
 
-Checkers::Move Checkers::Player::makeMove(Checkers::Board const& board) {
-    Checkers::Move move;
-    std::vector<Checkers::Move> moveList;
-    std::string playerAction;
-    std::string savedGameFilePath;
-    bool playerMoved;
-    uint8_t i;
+Checkers::Duration Checkers::Player::getPreviousMoveTime() {
+    return this->previousMoveTime;
+}
 
-    // computer
+
+int Checkers::Player::getMaxDepthReached() {
     if(this->isComputer) {
-        moveList = this->game->getMovesFromBoard_andPlayer(board, this->game->getPlayerTurn());
+        return this->maxDepthReached;
+    } else {
+        return -1;
+    }
+}
 
-        if(!moveList.size()) {
-            move.player = this->game->getPlayerTurn();
-            move.xPath[0] = move.yPath[0] = 0xFFU;
-            playerMoved = true;
-            this->game->stop();
+
+// nodes visited by all threads of the last search
+uint64_t Checkers::Player::getNodeCount() {
+    uint64_t nodes = 0;
+
+    for(unsigned int i = 0; i < this->threads.size(); i++) {
+        nodes += __atomic_load_n(&this->threads[i].nodes, __ATOMIC_RELAXED);
+    }
+
+    return nodes;
+}
+
+
+// (after the search; they are also counted by getNodeCount)
+uint64_t Checkers::Player::getQuiescenceNodeCount() {
+    uint64_t nodes = 0;
+
+    for(unsigned int i = 0; i < this->threads.size(); i++) {
+        nodes += this->threads[i].quiescenceNodes;
+    }
+
+    return nodes;
+}
+
+
+void Checkers::Player::setDepthLimit(int depthLimit) {
+    this->depthLimit = std::min(std::max(depthLimit, 1), 49);
+}
+
+
+void Checkers::Player::setNodeLimit(uint64_t nodeLimit) {
+    this->nodeLimit = nodeLimit;
+}
+
+
+void Checkers::Player::setThreadCount(unsigned int threadCount) {
+    this->threadCount = std::max(1U, threadCount);
+}
+
+
+void Checkers::Player::setTimeLimit(double timeLimit) {
+    this->timeManager.setMoveTime(timeLimit);
+}
+
+
+void Checkers::Player::setGameTime(double timeRemaining, double timeIncrement) {
+    this->timeManager.setGameTime(timeRemaining, timeIncrement);
+}
+
+
+// a stop request also ends any later search right away, until it is cleared
+void Checkers::Player::stopSearch() {
+    *this->stopRequest = true;
+}
+
+
+void Checkers::Player::clearStopRequest() {
+    *this->stopRequest = false;
+}
+
+
+// the callback is called from the main search thread
+void Checkers::Player::setInfoCallback(std::function<void(SearchInfo const&)> const& infoCallback) {
+    this->infoCallback = infoCallback;
+}
+
+
+void Checkers::Player::setStatisticsCallback(std::function<void(SearchStatistics const&)> const& statisticsCallback) {
+    this->statisticsCallback = statisticsCallback;
+}
+
+
+// rates are fractions (null without anything to divide by); the branching factor of an iteration is its node
+// count over the previous one's, and the effective branching factor of the search is the depth-th root of the
+// node count of its finished iterations
+std::string Checkers::Player::getJsonFromStatistics(Checkers::SearchStatistics const& statistics) {
+    std::ostringstream json;
+    uint64_t finishedNodes = 0;
+    size_t i;
+
+    auto writeRate = [&](std::string const& name, double numerator, double denominator) {
+        json << ",\"" << name << "\":";
+        if(denominator > 0) {
+            json << numerator / denominator;
+        } else {
+            json << "null";
         }
+    };
 
-        else if(moveList.size() == 1) {
-            move = moveList[0];
-            this->maxDepthReached = 0;
+    auto writeArray = [&](std::string const& name, std::vector<uint64_t> const& values) {
+        json << ",\"" << name << "\":[";
+        for(i = 0; i < values.size(); i++) {
+            json << (i ? "," : "") << values[i];
         }
+        json << "]";
+    };
 
-        else {
-            //move = moveList[std::rand() & (moveList.size() - 1)]; // pick randomly
-            move = this->pickMoveFromBoard(board); // pick using alpha beta
+    for(i = 0; i < statistics.iterations.size(); i++) {
+        if(statistics.iterations[i].finished) {
+            finishedNodes += statistics.iterations[i].nodes;
         }
     }
 
-    // human
-    else {
-        playerMoved = false;
+    json << "{\"position\":\"" << statistics.position << "\""
+         << ",\"move\":\"" << Checkers::Game::parseMove(statistics.move) << "\""
+         << ",\"depth\":" << statistics.depth
+         << ",\"score\":" << statistics.score
+         << ",\"nodes\":" << statistics.nodes
+         << ",\"seconds\":" << statistics.seconds;
+    writeRate("nodesPerSecond", statistics.nodes, statistics.seconds);
+    json << ",\"effectiveBranchingFactor\":";
+    if(statistics.depth > 0 && finishedNodes) {
+        json << std::pow((double) finishedNodes, 1.0 / statistics.depth);
+    } else {
+        json << "null";
+    }
 
-        // get possible moves
-        moveList = this->game->getMovesFromBoard_andPlayer(board, this->game->getPlayerTurn());
+    json << ",\"iterations\":[";
+    for(i = 0; i < statistics.iterations.size(); i++) {
+        Checkers::IterationStatistics const& iteration = statistics.iterations[i];
+
+        json << (i ? "," : "") << "{\"depth\":" << iteration.depth
+             << ",\"finished\":" << (iteration.finished ? "true" : "false")
+             << ",\"nodes\":" << iteration.nodes
+             << ",\"evaluations\":" << iteration.evaluations
+             << ",\"expandedNodes\":" << iteration.expandedNodes
+             << ",\"cutoffs\":" << iteration.cutoffs
+             << ",\"firstMoveCutoffs\":" << iteration.firstMoveCutoffs
+             << ",\"tableProbes\":" << iteration.tableProbes
+             << ",\"tableHits\":" << iteration.tableHits
+             << ",\"seconds\":" << iteration.seconds;
+        writeRate("cutoffRate", iteration.cutoffs, iteration.expandedNodes);
+        writeRate("firstMoveCutoffRate", iteration.firstMoveCutoffs, iteration.cutoffs);
+        writeRate("tableHitRate", iteration.tableHits, iteration.tableProbes);
+        writeRate("branchingFactor", iteration.nodes, i ? statistics.iterations[i - 1].nodes : 0);
+        json << "}";
+    }
+    json << "]";
 
-        // if there are no possible moves, end the game
-        if(!moveList.size()) {
-            move.player = this->game->getPlayerTurn();
-            move.xPath[0] = move.yPath[0] = 0xFFU;
-            playerMoved = true;
-            this->game->stop();
-        }
+    writeArray("plyNodes", statistics.plyNodes);
+    writeArray("plyEvaluations", statistics.plyEvaluations);
+    json << "}";
 
-        while(!playerMoved) {
-            for(i = 0; i < moveList.size(); i++) {
-                std::cout << "  [" << (i + 1) << "]  " << this->game->parseMove(moveList[i]) << std::endl;
-            }
-            std::cout << "  [S]  Save game" << std::endl;
-            std::cout << "  [Q]  Forfeit game" << std::endl;
-            
-            while((std::cout << "Please select an action: ")
-                    && (!(std::cin >> playerAction)
-                        || (   (playerAction.c_str()[0] != 'S' && playerAction.c_str()[0] != 's')
-                            && (playerAction.c_str()[0] != 'Q' && playerAction.c_str()[0] != 'q')
-                            && ((uint8_t) std::strtoll(playerAction.c_str(), nullptr, 10) < 1
-                                || (uint8_t) std::strtoll(playerAction.c_str(), nullptr, 10) > moveList.size())))) {
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
-            
-            if(playerAction.c_str()[0] == 'S' || playerAction.c_str()[0] == 's') {
-                std::cout << "Please enter a saved game file path: ";
-                std::cin >> savedGameFilePath;
-                this->game->save(savedGameFilePath);
-            } else if(playerAction.c_str()[0] == 'Q' || playerAction.c_str()[0] == 'q') {
-                move.player = this->game->getPlayerTurn();
-                move.xPath[0] = move.yPath[0] = 0xFFU;
-                playerMoved = true;
-                std::cout << "Quitting game ..." << std::endl;
-                this->game->stop();
-            } else {
-                move = moveList[std::strtoll(playerAction.c_str(), nullptr, 10) - 1];
-                playerMoved = true;
+    return json.str();
+}
+
+
+void Checkers::Player::setPonder(bool ponder) {
+    this->ponder = ponder;
+}
+
+
+void Checkers::Player::stopPondering() {
+    if(this->ponderSearch) {
+        this->ponderSearch->abort = true;
+        this->ponderSearch->thread.join();
+        this->ponderSearch.reset();
+    }
+}
+
+
+// Lazy SMP: every thread runs the same iterative deepening search over the shared table,
+// so the helper threads mostly fill the table with results the main thread reuses; it only
+// writes the search state, and the thread which waited for it copies the results into the player
+// (a ponder search runs while the game reads the player)
+Checkers::Move Checkers::Player::pickMoveFromBoard_andPlayer(Checkers::Board const& board, uint8_t player) {
+    std::vector<std::thread> helpers;
+    std::atomic<bool> stop(false);
+    Checkers::Time timeInitial = Checkers::Clock::now();
+    Checkers::SearchStatistics statistics;
+    unsigned int i, j, k;
+
+    // prepare the table for this search
+    this->table.resize(Checkers::transpositionTableSize);
+    this->table.newSearch();
+    this->timeManager.allocateMoveTime();
+    this->searchPlayer = player;
+
+    // forget the killer moves of the previous search, and age its history scores
+    this->threads.resize(std::max(1U, this->threadCount));
+    for(i = 0; i < this->threads.size(); i++) {
+        this->threads[i].index = i;
+        this->threads[i].stop = &stop;
+        this->threads[i].ponder = this->ponderSearch.get();
+        this->threads[i].nodes = 0;
+        this->threads[i].quiescenceNodes = 0;
+        this->threads[i].maxDepthReached = 0;
+        this->threads[i].score = 0;
+        std::fill(this->threads[i].plyNodes, this->threads[i].plyNodes + 50, 0);
+        std::fill(this->threads[i].plyEvaluations, this->threads[i].plyEvaluations + 50, 0);
+        this->threads[i].iterations.clear();
+
+        std::fill(&this->threads[i].killers[0][0], &this->threads[i].killers[0][0] + 50 * 2, 0);
+        for(j = 0; j < 32; j++) {
+            for(k = 0; k < 32; k++) {
+                this->threads[i].history[j][k] /= 2;
             }
         }
     }
 
-    return move;
+    for(i = 1; i < this->threads.size(); i++) {
+        helpers.push_back(std::thread(&Checkers::Player::searchFromBoard, this, std::cref(board), std::ref(this->threads[i])));
+    }
+
+    this->searchFromBoard(board, this->threads[0]);
+
+    // the main thread has its move; stop the helpers
+    stop = true;
+    for(i = 0; i < helpers.size(); i++) {
+        helpers[i].join();
+    }
+
+    if(this->statisticsCallback) {
+        statistics.position = Checkers::Game::getStringFromBoard_andPlayer(board, player);
+        statistics.move = this->threads[0].bestMove;
+        statistics.depth = this->threads[0].maxDepthReached;
+        statistics.score = this->threads[0].score;
+        statistics.nodes = this->getNodeCount();
+        statistics.seconds = std::chrono::duration<double>(Checkers::Clock::now() - timeInitial).count();
+        statistics.iterations = this->threads[0].iterations;
+        i = 50;
+        while(i > 0 && !this->threads[0].plyNodes[i - 1]) {
+            i--;
+        }
+        statistics.plyNodes.assign(this->threads[0].plyNodes, this->threads[0].plyNodes + i);
+        statistics.plyEvaluations.assign(this->threads[0].plyEvaluations, this->threads[0].plyEvaluations + i);
+        this->statisticsCallback(statistics);
+    }
+
+    return this->threads[0].bestMove;
 }
 
 
-Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board) {
-    // the tree variables
-    uint8_t depth, maxDepthReached = 1;
+// the expected reply is the one of the principal variation; there is nothing to gain from pondering
+// when the expected board leaves this player a single move (or none), which are played right away
+void Checkers::Player::startPondering(Checkers::Board const& board, Checkers::Move const& move) {
+    std::vector<Checkers::Move> principalVariation = this->getPrincipalVariation(board, move, 2);
+    Checkers::PonderSearch * ponderSearch;
+    Checkers::Board ponderBoard;
+    uint8_t player = move.player;
+
+    // a search still running from the last move would be left without a time limit
+    this->stopPondering();
+
+    if(principalVariation.size() < 2) {
+        return;
+    }
+
+    ponderBoard = Checkers::Game::getNextBoardFromMove_andBoard(move, board);
+    ponderBoard = Checkers::Game::getNextBoardFromMove_andBoard(principalVariation[1], ponderBoard);
+    if(Checkers::Game::getMovesFromBoard_andPlayer(ponderBoard, player).size() < 2) {
+        return;
+    }
+
+    this->keyHistory = this->game->getKeyHistory();
+    Checkers::Game::addMoveToKeyHistory(this->keyHistory, board, move);
+    Checkers::Game::addMoveToKeyHistory(this->keyHistory, Checkers::Game::getNextBoardFromMove_andBoard(move, board), principalVariation[1]);
+
+    this->ponderSearch = std::make_shared<Checkers::PonderSearch>();
+    ponderSearch = this->ponderSearch.get();
+    ponderSearch->active = true;
+    ponderSearch->abort = false;
+    ponderSearch->board = ponderBoard;
+    ponderSearch->thread = std::thread([this, ponderSearch, player]() {
+        ponderSearch->move = this->pickMoveFromBoard_andPlayer(ponderSearch->board, player);
+        ponderSearch->maxDepthReached = this->threads[0].maxDepthReached;
+    });
+}
+
+
+void Checkers::Player::searchFromBoard(Checkers::Board const& board, Checkers::SearchThread& thread) {
+    // the tree variables (odd helper threads start one depth deeper, so the threads spread over depths)
+    uint8_t depth, maxDepthReached = 1 + (thread.index & 1);
     struct {
         bool isMaxNode;
         int alpha;
         int beta;
+        int alphaInitial; // window the node was entered with (decides the bound stored in the table)
+        int betaInitial;
+        bool nullWindow;  // entered with a null window, to be searched again if it falls inside the parent's
+        bool research;    // the move being searched is searched again with the full window
         int value;
-        Checkers::Board nodeBoard;
-        std::vector<Checkers::Move> nodeMoves;
+        Checkers::MoveUndo nodeUndo; // takes back the move which led to the node
+        uint64_t nodeKey;
+        int nodeScore; // piece-square score of the node's board
+        int reversiblePlies; // plies since the last capture or regular piece move (only those can repeat)
+        Checkers::MoveList nodeMoves;
+        bool leafScoresReady; // leafScores holds the evaluation of each child (once the first child is a leaf)
+        int leafScores[Checkers::maxMoves];
+        uint8_t moveOrder[Checkers::maxMoves]; // indices into nodeMoves, in search order
         int moveIterator;
         int numMoves;
+        int bestMoveIndex;
     } nodeStack[50]; // i is even => max node, i is odd => min node
 
+    // the board of the current node; moves are made and taken back on it in place
+    Checkers::Board searchBoard;
+
     // player variables
     uint8_t players[2];
-    players[0] = this->game->getPlayerTurn();
+    players[0] = this->searchPlayer;
     players[1] = (~players[0]) & 1;
 
-    // move variables
-    Checkers::Move theMove;
+    // time variables (a ponder search starts the clock once the opponent has played the expected reply)
+    bool pondering = thread.ponder != nullptr;
+    bool timeUp = false;
+    Checkers::Time timeInitial = pondering ? Checkers::Clock::now() : this->searchStartTime;
+    Checkers::Time iterationStart = Checkers::Clock::now();
+    double iterationSeconds = 0, previousIterationSeconds = 0;
+    uint64_t nextTimeCheck = thread.nodes + Checkers::timeCheckInterval;
+
+    auto getSecondsElapsed = [&]() {
+        return std::chrono::duration<double>(Checkers::Clock::now() - timeInitial).count();
+    };
+
+    // the search is over once it is out of nodes, or stopped (by the main thread, a stop request, or the
+    // opponent playing another move than the expected one), or past the hard time limit; all but the
+    // node count are only checked every few nodes, which keeps the clock out of the inner loop
+    auto isTimeUp = [&]() {
+        if(this->nodeLimit && thread.nodes >= this->nodeLimit) {
+            return true;
+        } else if(thread.nodes < nextTimeCheck) {
+            return false;
+        }
+        nextTimeCheck = thread.nodes + Checkers::timeCheckInterval;
+
+        if(    thread.stop->load(std::memory_order_relaxed) || this->stopRequest->load(std::memory_order_relaxed)
+            || (pondering && thread.ponder->abort.load(std::memory_order_relaxed))) {
+            return true;
+        }
+
+        if(pondering) {
+            if(thread.ponder->active.load(std::memory_order_acquire)) {
+                return false;
+            }
+            pondering = false;
+            timeInitial = this->searchStartTime;
+        }
+
+        return getSecondsElapsed() >= this->timeManager.getHardLimit();
+    };
+
+    // repetition variables (the game's history only counts if it leads to the root)
+    size_t historySize = !this->keyHistory.empty() && this->keyHistory.back() == Checkers::Game::getKeyFromBoard_andPlayer(board, players[0])
+                         ? this->keyHistory.size() - 1 : 0;
+
+    // a position of the search path, or of the game before it, coming again (with the same player to move)
+    // is scored as a draw: either side able to do better would avoid it
+    auto isRepetition = [&](int depth) {
+        int plies;
+        for(plies = 4; plies <= nodeStack[depth].reversiblePlies; plies += 2) {
+            if(nodeStack[depth].nodeKey == (plies <= depth ? nodeStack[depth - plies].nodeKey : this->keyHistory[historySize - (plies - depth)])) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // table variables
+    Checkers::TableEntry entry;
+    uint8_t bound;
+    bool tableHit;
 
-    // time variables
-    Checkers::Time timeInitial = this->game->getMoveStartTime();
-    Checkers::Duration timeDiff;
-    double timeRemaining = this->timeLimit;
+    auto probeTable = [&](uint64_t key) {
+        bool hit = this->table.probe(key, entry);
+        thread.iteration.tableProbes++;
+        thread.iteration.tableHits += hit;
+        return hit;
+    };
 
-    int score, bestMoveIndex; //bestMoveIndexFinished;
+    // statistics of the current iteration (from the node count at its start)
+    uint64_t iterationNodes = thread.nodes;
+    thread.iteration = Checkers::IterationStatistics();
+
+    // tablebase variables
+    Checkers::TablebaseResult result, rootResult;
+    Checkers::Board nextBoard;
+    Checkers::MoveUndo undo;
+    int i, numMoves;
+
+    // children of the current horizon node, evaluated together
+    Checkers::EvaluationBlock leafBlock;
+
+    int score;
+
+    // aspiration window of the root
+    int windowAlpha = INT_MIN, windowBeta = INT_MAX, windowDelta = aspirationWindow;
 
     // initialize the root node
-    nodeStack[0].nodeBoard = board;
-    nodeStack[0].nodeMoves = Checkers::Game::getMovesFromBoard_andPlayer(board, players[0]);
-    nodeStack[0].numMoves = nodeStack[0].nodeMoves.size();
+    nodeStack[0].nodeKey = Checkers::Game::getKeyFromBoard_andPlayer(board, players[0]);
+    nodeStack[0].nodeScore = Checkers::Player::getPieceSquareScoreFromBoard(board);
+    nodeStack[0].reversiblePlies = historySize;
+    Checkers::Game::getMovesFromBoard_andPlayer(board, players[0], nodeStack[0].nodeMoves);
+    nodeStack[0].numMoves = nodeStack[0].nodeMoves.size;
     nodeStack[0].isMaxNode = true;
 
+    // a root in the tablebase keeps only the moves which keep its result; the search then picks among
+    // them by the tablebase results and evaluations at its leaves (the interior nodes are not cut off
+    // by the tablebase, which would leave every winning move looking alike)
+    rootResult = this->tablebase.probe(board, players[0]);
+    if(rootResult != Checkers::tablebaseUnknown) {
+        for(i = numMoves = 0; i < nodeStack[0].numMoves; i++) {
+            nextBoard = board;
+            Checkers::Game::makeMoveOnBoard(nodeStack[0].nodeMoves.moves[i], nextBoard, undo);
+
+            result = nextBoard.pieces[players[1]] ? this->tablebase.probe(nextBoard, players[1]) : Checkers::tablebaseLoss;
+            if(    (rootResult == Checkers::tablebaseWin && result == Checkers::tablebaseLoss)
+                || (rootResult == Checkers::tablebaseDraw && result == Checkers::tablebaseDraw)
+                || rootResult == Checkers::tablebaseLoss) {
+                nodeStack[0].nodeMoves.moves[numMoves++] = nodeStack[0].nodeMoves.moves[i];
+            }
+        }
+
+        nodeStack[0].nodeMoves.size = nodeStack[0].numMoves = numMoves;
+    }
+
+    // fall back on the first move if not even the first iteration finishes
+    if(nodeStack[0].numMoves) {
+        thread.bestMove = nodeStack[0].nodeMoves.moves[0];
+    }
+
     do {
         depth = 0;
+        searchBoard = board;
 
         // refresh the root node
-        nodeStack[0].alpha = INT_MIN;
-        nodeStack[0].beta = INT_MAX;
+        nodeStack[0].alpha = nodeStack[0].alphaInitial = windowAlpha;
+        nodeStack[0].beta = nodeStack[0].betaInitial = windowBeta;
         nodeStack[0].value = INT_MIN;
         nodeStack[0].moveIterator = 0;
+        nodeStack[0].leafScoresReady = false;
+        nodeStack[0].bestMoveIndex = 0;
+        nodeStack[0].research = false;
+
+        // search the best move of the previous iteration first
+        tableHit = this->table.probe(nodeStack[0].nodeKey, entry);
+        this->orderMoves(nodeStack[0].nodeMoves, nodeStack[0].moveOrder, 0, tableHit ? entry.moveIndex : 0xFFU, thread);
 
-        // while we still haven't checked all the moves of the root node
-        while(nodeStack[0].moveIterator < nodeStack[0].numMoves && timeRemaining > Checkers::timeRemainingThreshold) {
+        // while we still haven't checked all the moves of the root node (the last one is done once back at the root)
+        while((nodeStack[0].moveIterator < nodeStack[0].numMoves || depth) && !timeUp) {
             // no need to evaluate other moves; either a cut off, or all moves were evaluated
             if(    nodeStack[depth].beta <= nodeStack[depth].alpha
                 || nodeStack[depth].moveIterator >= nodeStack[depth].numMoves) {
                 // stop evaluating children
-                // update the parent, decrease the depth
+                // record the node in the table (unless the table settled it), update the parent, decrease the depth
+
+                if(depth && nodeStack[depth].numMoves) {
+                    if(nodeStack[depth].beta <= nodeStack[depth].alpha) {
+                        thread.iteration.cutoffs++;
+                        thread.iteration.firstMoveCutoffs += nodeStack[depth].moveIterator == 1;
+                    }
+
+                    if(nodeStack[depth].beta <= nodeStack[depth].alpha && nodeStack[depth].bestMoveIndex != 0xFF) {
+                        this->addCutoffMove(  nodeStack[depth].nodeMoves.moves[nodeStack[depth].bestMoveIndex], depth
+                                            , std::max(maxDepthReached - depth, 0), thread);
+                    }
+
+                    if(nodeStack[depth].value >= nodeStack[depth].betaInitial) {
+                        bound = Checkers::lowerBound;
+                    } else if(nodeStack[depth].value <= nodeStack[depth].alphaInitial) {
+                        bound = Checkers::upperBound;
+                    } else {
+                        bound = Checkers::exactBound;
+                    }
+
+                    this->table.store(nodeStack[depth].nodeKey, std::max(maxDepthReached - depth, 0), bound
+                                      , nodeStack[depth].value, nodeStack[depth].bestMoveIndex);
+                }
+
+                if(depth) {
+                    Checkers::Game::unmakeMoveOnBoard(nodeStack[depth].nodeUndo, searchBoard);
+                }
 
                 if(!depth--) {
                     if(nodeStack[1].value > nodeStack[0].value) {
                         nodeStack[0].value = nodeStack[1].value;
-                        bestMoveIndex = nodeStack[0].moveIterator - 1;
+                        nodeStack[0].bestMoveIndex = nodeStack[0].moveOrder[nodeStack[0].moveIterator - 1];
                     }
 
                     if(nodeStack[0].value > nodeStack[0].alpha) {
@@ -218,12 +1667,20 @@ Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board)
                     break;
                 }
 
+                // a null window search which fails high (low below a min node) only tells the move is better
+                // than the best one so far; it is searched again with the full window for its score
+                if(    nodeStack[depth + 1].nullWindow
+                    && nodeStack[depth + 1].value > nodeStack[depth].alpha
+                    && nodeStack[depth + 1].value < nodeStack[depth].beta) {
+                    nodeStack[depth].moveIterator--;
+                    nodeStack[depth].research = true;
+                    continue;
+                }
+
                 if(nodeStack[depth].isMaxNode) {
                     if(nodeStack[depth + 1].value > nodeStack[depth].value) {
                         nodeStack[depth].value = nodeStack[depth + 1].value;
-                        if(!depth) {
-                            bestMoveIndex = nodeStack[depth].moveIterator - 1;
-                        }
+                        nodeStack[depth].bestMoveIndex = nodeStack[depth].moveOrder[nodeStack[depth].moveIterator - 1];
                     }
                     
                     if(nodeStack[depth].value > nodeStack[depth].alpha) {
@@ -234,6 +1691,7 @@ Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board)
                 else {
                     if(nodeStack[depth + 1].value < nodeStack[depth].value) {
                         nodeStack[depth].value = nodeStack[depth + 1].value;
+                        nodeStack[depth].bestMoveIndex = nodeStack[depth].moveOrder[nodeStack[depth].moveIterator - 1];
                     }
                     
                     if(nodeStack[depth].value < nodeStack[depth].beta) {
@@ -244,14 +1702,26 @@ Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board)
 
             // we still need to evaluate other moves
             else {
-                // get the next node's board from our list of moves, then increment the move iterator
-                nodeStack[depth + 1].nodeBoard =
-                    this->game->getNextBoardFromMove_andBoard(nodeStack[depth].nodeMoves[nodeStack[depth].moveIterator]
-                                                              , nodeStack[depth].nodeBoard);
+                // make the next move from our list of moves on the board, then increment the move iterator
+                Checkers::Game::makeMoveOnBoard(nodeStack[depth].nodeMoves.moves[nodeStack[depth].moveOrder[nodeStack[depth].moveIterator]]
+                                                , searchBoard, nodeStack[depth + 1].nodeUndo);
+                nodeStack[depth + 1].nodeKey =
+                    Checkers::Game::getNextKeyFromMoveUndo(nodeStack[depth].nodeKey, nodeStack[depth + 1].nodeUndo);
+                nodeStack[depth + 1].nodeScore =
+                    Checkers::Player::getNextPieceSquareScoreFromMoveUndo(nodeStack[depth].nodeScore, nodeStack[depth + 1].nodeUndo);
+                nodeStack[depth + 1].reversiblePlies = nodeStack[depth + 1].nodeUndo.captured || !nodeStack[depth + 1].nodeUndo.wasKing
+                                                       ? 0 : nodeStack[depth].reversiblePlies + 1;
                 nodeStack[depth].moveIterator++;
+                __atomic_store_n(&thread.nodes, thread.nodes + 1, __ATOMIC_RELAXED); // read by getNodeCount during the search
+                if(depth >= maxDepthReached) {
+                    thread.quiescenceNodes++;
+                }
+                thread.plyNodes[depth + 1]++;
 
-                // next node is not @ max depth... 
-                if(depth + 1 < maxDepthReached) {
+                // next node is not @ max depth, or it is but has a capture pending; captures are forced, so the
+                // quiescence search plays them out (and nothing else) until the position is quiet enough to evaluate
+                if(    depth + 1 < maxDepthReached
+                    || (depth + 1 < 49 && Checkers::Game::hasCaptureFromBoard_andPlayer(searchBoard, players[(depth + 1) & 1]))) {
                     // go one level deeper
                     depth++;
 
@@ -259,25 +1729,100 @@ Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board)
                     nodeStack[depth].isMaxNode = !nodeStack[depth - 1].isMaxNode;
 
                     nodeStack[depth].value = nodeStack[depth].isMaxNode? INT_MIN :INT_MAX;
-                    nodeStack[depth].beta = nodeStack[depth - 1].beta;
-                    nodeStack[depth].alpha = nodeStack[depth - 1].alpha;
-
-                    nodeStack[depth].nodeMoves = Checkers::Game::getMovesFromBoard_andPlayer(nodeStack[depth].nodeBoard, players[depth & 1]);
-                    nodeStack[depth].numMoves = nodeStack[depth].nodeMoves.size();
+                    nodeStack[depth].beta = nodeStack[depth].betaInitial = nodeStack[depth - 1].beta;
+                    nodeStack[depth].alpha = nodeStack[depth].alphaInitial = nodeStack[depth - 1].alpha;
+
+                    // principal variation search: the first move (expected to be the best) gets the full window,
+                    // the others a null window just proving them no better
+                    nodeStack[depth].nullWindow = nodeStack[depth - 1].moveIterator > 1 && !nodeStack[depth - 1].research;
+                    if(nodeStack[depth].nullWindow && nodeStack[depth - 1].isMaxNode) {
+                        nodeStack[depth].beta = nodeStack[depth].betaInitial = nodeStack[depth].alpha + 1;
+                    } else if(nodeStack[depth].nullWindow) {
+                        nodeStack[depth].alpha = nodeStack[depth].alphaInitial = nodeStack[depth].beta - 1;
+                    }
+                    nodeStack[depth - 1].research = false;
 
                     nodeStack[depth].moveIterator = 0;
+                    nodeStack[depth].leafScoresReady = false;
+                    nodeStack[depth].research = false;
+                    nodeStack[depth].bestMoveIndex = 0xFF;
+
+                    // a repetition is a draw, whatever the table (which does not know the path) says
+                    tableHit = false;
+                    if(isRepetition(depth)) {
+                        nodeStack[depth].value = 0;
+                        nodeStack[depth].numMoves = 0;
+                    }
+
+                    // a deep enough table result which is exact or falls outside the window settles the node
+                    else if(    (tableHit = probeTable(nodeStack[depth].nodeKey))
+                             && entry.depth >= maxDepthReached - depth
+                             && (   entry.bound == Checkers::exactBound
+                                 || (entry.bound == Checkers::lowerBound && entry.score >= nodeStack[depth].beta)
+                                 || (entry.bound == Checkers::upperBound && entry.score <= nodeStack[depth].alpha))) {
+                        nodeStack[depth].value = entry.score;
+                        nodeStack[depth].numMoves = 0;
+                    }
+
+                    // once captures bring the piece count into the tablebase, its result settles the node
+                    else if(    rootResult == Checkers::tablebaseUnknown
+                             && (result = this->tablebase.probe(searchBoard, players[depth & 1])) != Checkers::tablebaseUnknown) {
+                        nodeStack[depth].value = this->getScoreFromTablebaseResult(result, players[depth & 1], nodeStack[depth].nodeScore);
+                        nodeStack[depth].numMoves = 0;
+                    }
+
+                    // otherwise, search the node's moves (the table's best move first)
+                    else {
+                        Checkers::Game::getMovesFromBoard_andPlayer(searchBoard, players[depth & 1], nodeStack[depth].nodeMoves);
+                        nodeStack[depth].numMoves = nodeStack[depth].nodeMoves.size;
+                        this->orderMoves(nodeStack[depth].nodeMoves, nodeStack[depth].moveOrder
+                                         , depth, tableHit ? entry.moveIndex : 0xFFU, thread);
+                        thread.iteration.expandedNodes++;
+                    }
                 }
                 
                 // next node is leaf node => we evaluate heuristic function and update our values
                 else {
-                    score = this->evaluateBoard(nodeStack[depth + 1].nodeBoard);
+                    // evaluations are kept in the table as exact zero depth results (repetitions are not, as they depend on the path)
+                    if(isRepetition(depth + 1)) {
+                        score = 0;
+                    } else if(probeTable(nodeStack[depth + 1].nodeKey) && entry.bound == Checkers::exactBound) {
+                        score = entry.score;
+                    } else {
+                        result = this->tablebase.probe(searchBoard, players[(depth + 1) & 1]);
+                        if(result != Checkers::tablebaseUnknown) {
+                            score = this->getScoreFromTablebaseResult(result, players[(depth + 1) & 1], nodeStack[depth + 1].nodeScore);
+                        } else {
+                            // the first child needing an evaluation has every child evaluated along with it
+                            if(!nodeStack[depth].leafScoresReady) {
+                                nextBoard = searchBoard;
+                                Checkers::Game::unmakeMoveOnBoard(nodeStack[depth + 1].nodeUndo, nextBoard);
+                                leafBlock.size = nodeStack[depth].nodeMoves.size;
+                                for(i = 0; i < leafBlock.size; i++) {
+                                    Checkers::Game::makeMoveOnBoard(nodeStack[depth].nodeMoves.moves[i], nextBoard, undo);
+                                    leafBlock.pieces[0][i] = nextBoard.pieces[0];
+                                    leafBlock.pieces[1][i] = nextBoard.pieces[1];
+                                    leafBlock.kings[i] = nextBoard.kings;
+                                    leafBlock.pieceSquareScores[i] =
+                                        Checkers::Player::getNextPieceSquareScoreFromMoveUndo(nodeStack[depth].nodeScore, undo);
+                                    Checkers::Game::unmakeMoveOnBoard(undo, nextBoard);
+                                }
+                                this->evaluateBlock(leafBlock, nodeStack[depth].leafScores);
+                                nodeStack[depth].leafScoresReady = true;
+                            }
+                            score = nodeStack[depth].leafScores[nodeStack[depth].moveOrder[nodeStack[depth].moveIterator - 1]];
+                            thread.iteration.evaluations++;
+                            thread.plyEvaluations[depth + 1]++;
+                        }
+                        this->table.store(nodeStack[depth + 1].nodeKey, 0, Checkers::exactBound, score, 0xFFU);
+                    }
+
+                    Checkers::Game::unmakeMoveOnBoard(nodeStack[depth + 1].nodeUndo, searchBoard);
 
                     if(nodeStack[depth].isMaxNode) {
                         if(score > nodeStack[depth].value) {
                             nodeStack[depth].value = score;
-                            if(!depth) {
-                                bestMoveIndex = nodeStack[depth].moveIterator - 1;
-                            }
+                            nodeStack[depth].bestMoveIndex = nodeStack[depth].moveOrder[nodeStack[depth].moveIterator - 1];
                         }
                         
                         if(nodeStack[depth].value > nodeStack[depth].alpha) {
@@ -288,6 +1833,7 @@ Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board)
                     else {
                         if(score < nodeStack[depth].value) {
                             nodeStack[depth].value = score;
+                            nodeStack[depth].bestMoveIndex = nodeStack[depth].moveOrder[nodeStack[depth].moveIterator - 1];
                         }
 
                         if(nodeStack[depth].value < nodeStack[depth].beta) {
@@ -297,147 +1843,180 @@ Checkers::Move Checkers::Player::pickMoveFromBoard(Checkers::Board const& board)
                 }
             }
 
-            timeDiff = Checkers::Clock::now() - timeInitial;
-            timeRemaining = this->timeLimit - double(timeDiff.count()) * Checkers::Clock::period::num / Checkers::Clock::period::den;
+            timeUp = isTimeUp();
         }
         
-        // only update the move if the search finished
-        // also, only increase the max depth if it played a role in picking the move
-        if(timeRemaining > Checkers::timeRemainingThreshold) {
-            this->maxDepthReached = maxDepthReached++;
-            theMove = nodeStack[0].nodeMoves[bestMoveIndex];
+        // a score outside the aspiration window is only a bound; search the depth again with the window
+        // widened on that side, twice as far each time, until it is the full range
+        if(!timeUp && nodeStack[0].value <= windowAlpha && windowAlpha > INT_MIN) {
+            windowDelta *= 2;
+            windowAlpha = nodeStack[0].value - (long long) windowDelta > -tablebaseWinScore ? nodeStack[0].value - windowDelta : INT_MIN;
+            continue;
+        } else if(!timeUp && nodeStack[0].value >= windowBeta && windowBeta < INT_MAX) {
+            windowDelta *= 2;
+            windowBeta = nodeStack[0].value + (long long) windowDelta < tablebaseWinScore ? nodeStack[0].value + windowDelta : INT_MAX;
+            continue;
         }
-        timeDiff = Checkers::Clock::now() - timeInitial;
-        timeRemaining = this->timeLimit - double(timeDiff.count()) * Checkers::Clock::period::num / Checkers::Clock::period::den;
-    } while(timeRemaining > Checkers::timeRemainingThreshold && maxDepthReached < 50);
-
-    return theMove;
-}
-
-
-int Checkers::Player::evaluateBoard(Board const& board) {
-    int i, j;
-    int score[2] = {0};
-    int pieceCount[2] = {0};
-    uint8_t me = this->game->getPlayerTurn();
-    uint8_t opponent = ~me & 1;
-    uint8_t square;
-
-    Checkers::Piece tempPiece;
-
-    // challenge empty squares attacked by the enemy pieces
-    // control the sides
-
-    for(i = 0; i < 2; i++) {
-        for(j = 0; j < 12; j++) {
-            tempPiece = board.pieces[i][j];
-
-            if(tempPiece.xPos <= 7 && tempPiece.yPos <= 7) {
-                // track each player's piece counts (for checking for win conditions)
-                pieceCount[i]++;
-
-                // 1 : piece counts and types
-                score[i] += 15 * (100 + 80 * tempPiece.isKing);
-                
-                // 2 : protect regular pieces
-                if(tempPiece.yPos + (2 * i - 1) >= 0 && tempPiece.yPos + (2 * i - 1) <= 7 && !tempPiece.isKing) {
-                    if(tempPiece.xPos - 1 >= 0) {
-                        // check squares behind
-                        square = board.squares[tempPiece.yPos + (2 * i - 1)][tempPiece.xPos - 1];
-                        if(square != 4 && (square & 1) == i) {
-                            score[i] += 150;
-                        }
-                    }
 
-                    if(tempPiece.xPos + 1 <= 7) {
-                        // check squares behind
-                        square = board.squares[tempPiece.yPos + (2 * i - 1)][tempPiece.xPos + 1];
-                        if(square != 4 && (square & 1) == i) {
-                            score[i] += 150;
-                        }
-                    }
-
-                    // challenge enemy pieces
-                    if(tempPiece.yPos + (2 - 4 * i) >= 0 && tempPiece.yPos + (2 - 4 * i) <= 7) {
-                        square = board.squares[tempPiece.yPos + (2 - 4 * i)][tempPiece.xPos];
-                        if(square != 4 && (square & 1) == (~i & 1)) {
-                            score[i] += 100;
-                        }
-                    }
-                }
+        // only update the move if the search finished
+        // also, only increase the max depth if it played a role in picking the move
+        if(!timeUp) {
+            this->table.store(nodeStack[0].nodeKey, maxDepthReached, Checkers::exactBound
+                              , nodeStack[0].value, nodeStack[0].bestMoveIndex);
+            thread.maxDepthReached = maxDepthReached++;
+            thread.bestMove = nodeStack[0].nodeMoves.moves[nodeStack[0].bestMoveIndex];
+            thread.score = nodeStack[0].value;
+
+            if(!thread.index && this->infoCallback) {
+                Checkers::SearchInfo info;
+                info.depth = thread.maxDepthReached;
+                info.score = nodeStack[0].value;
+                info.nodes = this->getNodeCount();
+                info.seconds = getSecondsElapsed();
+                info.principalVariation = this->getPrincipalVariation(board, thread.bestMove, thread.maxDepthReached);
+                this->infoCallback(info);
+            }
 
-                // 3 : control the center
-                score[i] += 3 * (100 - ((abs(4 - tempPiece.xPos) + abs(4 - tempPiece.yPos)) * 10));
+            // the next iteration starts with an aspiration window around this score (unless the game is decided)
+            windowDelta = aspirationWindow;
+            if(nodeStack[0].value > -tablebaseWinScore && nodeStack[0].value < tablebaseWinScore) {
+                windowAlpha = nodeStack[0].value - windowDelta;
+                windowBeta = nodeStack[0].value + windowDelta;
+            } else {
+                windowAlpha = INT_MIN;
+                windowBeta = INT_MAX;
+            }
 
-                // 4 : advance regular pieces, and
-                // 5 : keep regular pieces on back rank if possible
-                if(!tempPiece.isKing) {
-                    score[i] += 5 * (10 * abs(7 * i - tempPiece.yPos));
-                    if(tempPiece.yPos == 7 * i) {
-                        score[i] += 300;
-                    }
-                }
-                
+            // the main thread starts another iteration only if the time manager expects it to finish
+            previousIterationSeconds = iterationSeconds;
+            iterationSeconds = std::chrono::duration<double>(Checkers::Clock::now() - iterationStart).count();
+            iterationStart = Checkers::Clock::now();
+
+            thread.iteration.depth = thread.maxDepthReached;
+            thread.iteration.finished = true;
+            thread.iteration.nodes = thread.nodes - iterationNodes;
+            thread.iteration.seconds = iterationSeconds;
+            thread.iterations.push_back(thread.iteration);
+            thread.iteration = Checkers::IterationStatistics();
+            iterationNodes = thread.nodes;
+            if(!thread.index && !pondering) {
+                timeUp = !this->timeManager.canStartIteration(getSecondsElapsed(), iterationSeconds, previousIterationSeconds);
             }
         }
-    }
-
-    // I have no more pieces => loss
-    if(!pieceCount[me]) {
-        return INT_MIN;
-    }
-
-    // opponent has no more pieces => win
-    if(!pieceCount[opponent]) {
-        return INT_MAX;
-    }
-
-    // I have no more moves => loss
-    if(Checkers::Game::getMovesFromBoard_andPlayer(board, me).size() == 0) {
-        return INT_MIN;
-    }
 
-    // opponent has no more moves => win
-    if(Checkers::Game::getMovesFromBoard_andPlayer(board, opponent).size() == 0) {
-        return INT_MAX;
+        // an unfinished iteration still tells if a move beat the previous best one, which is searched first
+        else if(!thread.index && nodeStack[0].value > nodeStack[0].alphaInitial) {
+            thread.bestMove = nodeStack[0].nodeMoves.moves[nodeStack[0].bestMoveIndex];
+        }
+    } while(!timeUp && maxDepthReached <= this->depthLimit);
+
+    if(thread.nodes > iterationNodes) {
+        thread.iteration.depth = maxDepthReached;
+        thread.iteration.finished = false;
+        thread.iteration.nodes = thread.nodes - iterationNodes;
+        thread.iteration.seconds = std::chrono::duration<double>(Checkers::Clock::now() - iterationStart).count();
+        thread.iterations.push_back(thread.iteration);
     }
-
-    // no clear win conditions met, we just return the score difference
-    return score[me] - score[opponent];
 }
 
 
-void Checkers::Player::addMadeMove(Checkers::Move const& move) {
-    this->moveList.push_back(move);
+// the table's best move goes first, then the killer moves of the depth, then the rest by history score
+void Checkers::Player::orderMoves(  Checkers::MoveList const& moves
+                                  , uint8_t * order
+                                  , uint8_t depth
+                                  , uint8_t tableMoveIndex
+                                  , Checkers::SearchThread& thread) {
+    int i, j, score;
+    int scores[Checkers::maxMoves];
+    uint16_t squares;
+
+    for(i = 0; i < moves.size; i++) {
+        squares = ((moves.moves[i].from << 5) | moves.moves[i].to) + 1;
+
+        if(i == tableMoveIndex) {
+            score = INT_MAX;
+        } else if(squares == thread.killers[depth][0]) {
+            score = INT_MAX - 1;
+        } else if(squares == thread.killers[depth][1]) {
+            score = INT_MAX - 2;
+        } else if(!depth && thread.index) {
+            score = -((i + thread.index) % moves.size); // helpers rotate the root moves
+        } else {
+            score = thread.history[moves.moves[i].from][moves.moves[i].to];
+        }
+
+        // insertion sort by descending score (move lists are short)
+        for(j = i; j > 0 && scores[j - 1] < score; j--) {
+            order[j] = order[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        order[j] = i;
+        scores[j] = score;
+    }
 }
 
 
-void Checkers::Player::addTotalMoveTime(Checkers::Duration const& moveTime) {
-    this->totalMoveTime += moveTime;
-}
+void Checkers::Player::addCutoffMove(Checkers::Move const& move, uint8_t depth, uint8_t remainingDepth, Checkers::SearchThread& thread) {
+    int i, j;
+    uint16_t squares = ((move.from << 5) | move.to) + 1;
 
+    if(thread.killers[depth][0] != squares) {
+        thread.killers[depth][1] = thread.killers[depth][0];
+        thread.killers[depth][0] = squares;
+    }
 
-void Checkers::Player::setPreviousMoveTime(Checkers::Duration const& moveTime) {
-    this->previousMoveTime = moveTime;
+    // deeper cutoffs count for more; halve every score before they can reach the killer scores
+    thread.history[move.from][move.to] += remainingDepth * remainingDepth;
+    if(thread.history[move.from][move.to] > (1 << 24)) {
+        for(i = 0; i < 32; i++) {
+            for(j = 0; j < 32; j++) {
+                thread.history[i][j] /= 2;
+            }
+        }
+    }
 }
 
 
-Checkers::Duration Checkers::Player::getTotalMoveTime() {
-    return this->totalMoveTime;
-}
+// scores are from the view of the player to move at the root; the piece-square score still tells
+// apart positions with the same result, so the search heads for the ones closer to being decided
+int Checkers::Player::getScoreFromTablebaseResult(TablebaseResult result, uint8_t player, int pieceSquareScore) {
+    uint8_t me = this->searchPlayer;
 
+    if(result == Checkers::tablebaseDraw) {
+        return 0;
+    }
 
-Checkers::Duration Checkers::Player::getPreviousMoveTime() {
-    return this->previousMoveTime;
+    return ((result == Checkers::tablebaseWin) == (player == me) ? tablebaseWinScore : -tablebaseWinScore)
+           + (me ? -pieceSquareScore : pieceSquareScore);
 }
 
 
-int Checkers::Player::getMaxDepthReached() {
-    if(this->isComputer) {
-        return this->maxDepthReached;
-    } else {
-        return -1;
+std::vector<Checkers::Move> Checkers::Player::getPrincipalVariation(Board const& board, Move const& bestMove, int depth) {
+    std::vector<Checkers::Move> principalVariation;
+    Checkers::Board nextBoard = board;
+    Checkers::MoveList moveList;
+    Checkers::TableEntry entry;
+    Checkers::Move move = bestMove;
+    uint8_t player = move.player;
+
+    while(true) {
+        principalVariation.push_back(move);
+        nextBoard = Checkers::Game::getNextBoardFromMove_andBoard(move, nextBoard);
+        player = (~player) & 1;
+
+        if(    (int) principalVariation.size() >= depth
+            || !this->table.probe(Checkers::Game::getKeyFromBoard_andPlayer(nextBoard, player), entry)) {
+            break;
+        }
+
+        Checkers::Game::getMovesFromBoard_andPlayer(nextBoard, player, moveList);
+        if(entry.moveIndex >= moveList.size) {
+            break;
+        }
+        move = moveList.moves[entry.moveIndex];
     }
+
+    return principalVariation;
 }
 ////////////////////////////////////
 // END  Player method definitions //
@@ -464,7 +2043,8 @@ Checkers::Game::Game() {
 void Checkers::Game::start(  bool playerOneComputer
                            , bool playerTwoComputer
                            , unsigned short playerFirstMove
-                           , double computerTimeLimit) {
+                           , double computerTimeLimit
+                           , bool computerPonder) {
     Checkers::Board board;
     Checkers::Move move;
     Checkers::Time ti, tf;
@@ -473,10 +2053,32 @@ void Checkers::Game::start(  bool playerOneComputer
     // initialize the players using given parameters
     this->players[0] = Checkers::Player(this, playerOneComputer, computerTimeLimit);
     this->players[1] = Checkers::Player(this, playerTwoComputer, computerTimeLimit);
+    this->players[0].setPonder(computerPonder);
+    this->players[1].setPonder(computerPonder);
+
+    // each record is wrapped with the player which searched (a ponder search may write while the other player searches)
+    if(!this->logFilePath.empty()) {
+        std::shared_ptr<std::ofstream> log = std::make_shared<std::ofstream>(this->logFilePath.c_str());
+        std::shared_ptr<std::mutex> logMutex = std::make_shared<std::mutex>();
+
+        if(!log->is_open()) {
+            std::cout << "Warning: Searches will not be logged!" << std::endl;
+            std::cout << "         Failed to open '" << this->logFilePath << "' for writing." << std::endl;
+        } else {
+            for(int i = 0; i < 2; i++) {
+                this->players[i].setStatisticsCallback([log, logMutex, i](Checkers::SearchStatistics const& statistics) {
+                    std::string record = Checkers::Player::getJsonFromStatistics(statistics);
+                    std::lock_guard<std::mutex> lock(*logMutex);
+                    *log << "{\"player\":" << i + 1 << ",\"search\":" << record << "}" << std::endl;
+                });
+            }
+        }
+    }
 
-    // set up game state variables
+    // set up game state variables (the history of a loaded game starts with its current position)
     this->inProgress = true;
     this->playerTurn = playerFirstMove;
+    this->keyHistory.assign(1, Checkers::Game::getKeyFromBoard_andPlayer(this->getCurrentBoard(), this->playerTurn));
 
     while(this->inProgress) {
         // print the board
@@ -513,6 +2115,7 @@ void Checkers::Game::start(  bool playerOneComputer
         this->numMovesSinceCapture++;
 
         // update the board
+        Checkers::Game::addMoveToKeyHistory(this->keyHistory, board, move);
         board = Checkers::Game::getNextBoardFromMove(move);
         this->setCurrentBoard(board);
         
@@ -520,17 +2123,21 @@ void Checkers::Game::start(  bool playerOneComputer
         this->playerTurn = (~this->playerTurn) & 1;
 
         // TODO: clean this up... it's kind of ugly
-        if(this->numMovesSinceCapture > Checkers::moveLimit) {
+        if(    this->numMovesSinceCapture > Checkers::moveLimit
+            || (unsigned int) std::count(this->keyHistory.begin(), this->keyHistory.end(), this->keyHistory.back()) >= Checkers::repetitionLimit) {
             this->stop();
         }
     }
 
+    this->players[0].stopPondering();
+    this->players[1].stopPondering();
+
     // if no move was made, there were no legal moves to make
-    if((move.xPath[0] > 7 || move.yPath[0] > 7) && this->numMovesSinceCapture <= Checkers::moveLimit) {
+    if(move.from > 31 && this->numMovesSinceCapture <= Checkers::moveLimit) {
         std::cout << "Game over! Player " << (this->playerTurn + 1) << " wins!" << std::endl;
     }
 
-    // the move limit was exceeded;  TODO: implement other official rules (a map for board states could prove useful)
+    // the move limit was exceeded, or a position was repeated too often
     else {
         std::cout << "Game over! Player 1 and Player 2 draw!" << std::endl;
     }
@@ -538,6 +2145,48 @@ void Checkers::Game::start(  bool playerOneComputer
 }
 
 
+// the game loop of start for two computer players (set up with this game), without any output;
+// returns the winning player, or -1 for a draw
+int Checkers::Game::play(Player const& playerOne, Player const& playerTwo, unsigned short playerFirstMove) {
+    Checkers::Move move;
+
+    this->players[0] = playerOne;
+    this->players[1] = playerTwo;
+
+    this->inProgress = true;
+    this->playerTurn = playerFirstMove & 1;
+    this->keyHistory.assign(1, Checkers::Game::getKeyFromBoard_andPlayer(this->getCurrentBoard(), this->playerTurn));
+
+    while(this->inProgress) {
+        this->moveStartTime = Checkers::Clock::now();
+        move = this->players[this->playerTurn].makeMove(this->getCurrentBoard());
+
+        this->moveList.push_back(move);
+        this->moveCount++;
+        this->numMovesSinceCapture++;
+
+        Checkers::Game::addMoveToKeyHistory(this->keyHistory, this->getCurrentBoard(), move);
+        this->setCurrentBoard(this->getNextBoardFromMove(move));
+        this->playerTurn = (~this->playerTurn) & 1;
+
+        if(    this->numMovesSinceCapture > Checkers::moveLimit
+            || (unsigned int) std::count(this->keyHistory.begin(), this->keyHistory.end(), this->keyHistory.back()) >= Checkers::repetitionLimit) {
+            this->stop();
+        }
+    }
+
+    this->players[0].stopPondering();
+    this->players[1].stopPondering();
+
+    // the player left without a move has lost, and the turn has passed on to the winner
+    if(move.from > 31 && this->numMovesSinceCapture <= Checkers::moveLimit) {
+        return this->playerTurn;
+    }
+
+    return -1;
+}
+
+
 void Checkers::Game::stop() {
     this->inProgress = false;
 }
@@ -545,55 +2194,27 @@ void Checkers::Game::stop() {
 
 // TODO: cover all bases w.r.t. initialization
 void Checkers::Game::reset() {
-    Checkers::Board board;
-    uint8_t i, j, m, n;
-    
-    // set rng seed
-    std::srand(std::time(0));
-
     // initialize relevant game state variables
     this->moveCount = 0;
     this->numMovesSinceCapture = 0;
+    this->keyHistory.clear();
     this->previousMoveTime = Duration::zero();
     this->totalMoveTime = Duration::zero();
 
     // initializing the board squares to beginning state
-    m = n = 0;
-    for(i = 0; i < 8; i++) {
-        
-        for(j = 0; j < 8; j++) {
-            if(!((i + j) & 1) && i < 3) {
-                board.squares[i][j] = 0; // player one reg.
-
-                board.pieces[0][m].isKing = false;
-                board.pieces[0][m].xPos = j;
-                board.pieces[0][m].yPos = i;
-
-                m++;
-            } else if(!((i + j) & 1) && i > 4) {
-                board.squares[i][j] = 1; // player two reg.
-
-                board.pieces[1][n].isKing = false;
-                board.pieces[1][n].xPos = j;
-                board.pieces[1][n].yPos = i;
+    this->setCurrentBoard(Checkers::Game::getStartBoard());
+}
 
-                n++;
-            } else {
-                board.squares[i][j] = 4; // empty
-            }
-        }
-    }
 
-    this->setCurrentBoard(board);
+void Checkers::Game::setLogFilePath(std::string const& filePath) {
+    this->logFilePath = filePath;
 }
 
 
 void Checkers::Game::load(std::string const& filePath) {
     std::ifstream inputFile(filePath.c_str());
     int i, j;
-    int k[2] = {0};
     int square;
-    uint8_t player;
 
     if(!inputFile.is_open()) {
         std::cout << "Warning: Game could not be loaded!" << std::endl;
@@ -602,32 +2223,13 @@ void Checkers::Game::load(std::string const& filePath) {
         Checkers::Board board;
 
         // initialize the board to "zero'd out" state
-        for(i = 0; i < 8; i++) {
-            for(j = 0; j < 8; j++) {
-                board.squares[i][j] = 4;
-            }
-        }
-        for(i = 0; i < 2; i++) {
-            for(j = 0; j < 12; j++) {
-                board.pieces[i][j].isKing = false;
-                board.pieces[i][j].xPos = 0xFFU;
-                board.pieces[i][j].yPos = 0xFFU;
-            }
-        }
+        board.pieces[0] = board.pieces[1] = board.kings = 0;
 
         // read in board and pieces
         for(i = 7; i >= 0; i--) {
             for(j = 0; j < 8; j++) {
                 inputFile >> square;
-                board.squares[i][j] = square;
-
-                if(square < 4) {
-                    player = square & 1;
-                    board.pieces[player][k[player]].isKing = square & 2;
-                    board.pieces[player][k[player]].xPos = j;
-                    board.pieces[player][k[player]].yPos = i;
-                    k[player]++;
-                }
+                Checkers::Game::setSquareOnBoard(board, j, i, square);
             }
         }
 
@@ -651,7 +2253,7 @@ void Checkers::Game::save(std::string const& filePath) {
         // write out board
         for(i = 7; i >= 0; i--) {
             for(j = 0; j < 8; j++) {
-                outputFile << int(board.squares[i][j]) << (j < 7 ? " " : "");
+                outputFile << int(Checkers::Game::getSquareFromBoard(board, j, i)) << (j < 7 ? " " : "");
             }
             outputFile << std::endl;
         }
@@ -672,457 +2274,382 @@ void Checkers::Game::setCurrentBoard(Checkers::Board const& board) {
 }
 
 
+Checkers::Board Checkers::Game::getStartBoard() {
+    Checkers::Board board;
+
+    board.pieces[0] = 0x00000FFFU; // player one reg. (rows 1 - 3)
+    board.pieces[1] = 0xFFF00000U; // player two reg. (rows 6 - 8)
+    board.kings = 0;
+
+    return board;
+}
+
+
 Checkers::Board Checkers::Game::getNextBoardFromMove(Move const& move) {
     Checkers::Board board = this->getCurrentBoard();
+    Checkers::Board nextBoard = Checkers::Game::getNextBoardFromMove_andBoard(move, board);
+
+    // a capture resets the number of moves since capture
+    if(nextBoard.pieces[(~move.player) & 1] != board.pieces[(~move.player) & 1]) {
+        this->numMovesSinceCapture = 0;
+    }
 
-    return Checkers::Game::getNextBoardFromMove_andBoard(move, board);
+    return nextBoard;
 }
 
 
 Checkers::Board Checkers::Game::getNextBoardFromMove_andBoard(Move const& move, Board const& board) {
-    int i;
     Checkers::Board tempBoard;
-    Checkers::Move tempMove;
-    signed short srcPiece;
-    signed short jmpPiece;
-    int xDiff, yDiff;
-    uint8_t opponent;
-    uint8_t xJmp, yJmp;
-    
-
-    // check for invalid move paths; return the given board if invalid
-    if(move.xPath[0] > 7 || move.yPath[0] > 7 || move.xPath[1] > 7 || move.yPath[1] > 7   // src/dest out of range
-        || ((move.xPath[0] + move.yPath[0]) & 1) || ((move.xPath[1] + move.yPath[1]) & 1) // src/dest is white square
-        || board.squares[move.yPath[1]][move.xPath[1]] != 4) {                            // dest square occupied
+    Checkers::MoveUndo undo;
+    uint8_t opponent = (~move.player) & 1;
+
+    // check for invalid moves; return the given board if invalid
+    if(    move.from > 31 || move.to > 31                                                    // src/dest out of range
+        || !(board.pieces[move.player] & (1U << move.from))                                   // src holds no piece of the player
+        || ((board.pieces[0] | board.pieces[1]) & (1U << move.to) & ~(1U << move.from))      // dest square occupied
+        || (move.captures & ~board.pieces[opponent])) {                                       // jumped square holds no enemy piece
         return board;
     }
 
+    tempBoard = board;
+    Checkers::Game::makeMoveOnBoard(move, tempBoard, undo);
 
-    // single move (no jump) => return after move
-    else if(abs(move.xPath[1] - move.xPath[0]) == 1 && abs(move.yPath[1] - move.yPath[0]) == 1) {
-        srcPiece = -1;
-        
-        // find the src piece
-        for(i = 0; i < 12; i++) {
-            if(    board.pieces[move.player][i].xPos == move.xPath[0]
-                && board.pieces[move.player][i].yPos == move.yPath[0]) {
-                srcPiece = i;
-            }
-        }
-
-        // inconsistent board check
-        if(srcPiece < 0) {
-            return board;
-        }
+    return tempBoard;
+}
 
-        tempBoard = board;
 
-        // handle promotion
-        if(!board.pieces[move.player][srcPiece].isKing && move.yPath[1] == 7 * ((~move.player) & 1)) {
-            tempBoard.pieces[move.player][srcPiece].isKing = true;
-        }
+// moves are assumed to be legal (as generated by getMovesFromBoard_andPlayer)
+void Checkers::Game::makeMoveOnBoard(Move const& move, Board& board, MoveUndo& undo) {
+    uint32_t fromBit = 1U << move.from;
+    uint32_t toBit = 1U << move.to;
+    uint8_t opponent = (~move.player) & 1;
+
+    undo.player = move.player;
+    undo.from = move.from;
+    undo.to = move.to;
+    undo.captured = move.captures;
+    undo.capturedKings = move.captures & board.kings;
+    undo.wasKing = board.kings & fromBit;
+    undo.promoted = !undo.wasKing && (toBit & backRanks[opponent]);
+
+    // a king's jumps may end on its starting square, so clear the start before setting the end
+    board.pieces[move.player] = (board.pieces[move.player] & ~fromBit) | toBit;
+    board.pieces[opponent] &= ~move.captures;
+    board.kings &= ~(move.captures | fromBit);
+    if(undo.wasKing || undo.promoted) {
+        board.kings |= toBit;
+    }
+}
 
-        // update the board
-        tempBoard.squares[move.yPath[0]][move.xPath[0]] = 4;
-        tempBoard.squares[move.yPath[1]][move.xPath[1]] = (int(tempBoard.pieces[move.player][srcPiece].isKing) << 1) | move.player;
 
-        // update the piece location
-        tempBoard.pieces[move.player][srcPiece].xPos = move.xPath[1];
-        tempBoard.pieces[move.player][srcPiece].yPos = move.yPath[1];
+void Checkers::Game::unmakeMoveOnBoard(MoveUndo const& undo, Board& board) {
+    uint32_t fromBit = 1U << undo.from;
+    uint32_t toBit = 1U << undo.to;
 
-        return tempBoard;
+    board.pieces[undo.player] = (board.pieces[undo.player] & ~toBit) | fromBit;
+    board.pieces[(~undo.player) & 1] |= undo.captured;
+    board.kings = (board.kings & ~toBit) | undo.capturedKings;
+    if(undo.wasKing) {
+        board.kings |= fromBit;
     }
+}
 
 
-    // jump move => perform jump; shift move path if no promotion
-    else if(abs(xDiff = (move.xPath[1] - move.xPath[0])) == 2 && abs(yDiff = (move.yPath[1] - move.yPath[0])) == 2) {
-        opponent = (~move.player) & 1;
-        srcPiece = -1;
+std::vector<Checkers::Move> Checkers::Game::getMovesFromBoard_andPlayer(Checkers::Board const& board, unsigned short player) {
+    Checkers::MoveList moveList;
 
-        // find the src and jmp pieces
-        for(i = 0; i < 12; i++) {
-            if(    board.pieces[move.player][i].xPos == move.xPath[0]
-                && board.pieces[move.player][i].yPos == move.yPath[0]) {
-                srcPiece = i;
-            }
-        }
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
 
-        // inconsistent board check
-        if(srcPiece < 0) {
-            return board;
-        }
+    return std::vector<Checkers::Move>(moveList.moves, moveList.moves + moveList.size);
+}
 
-        tempBoard = board;
-        tempMove = move;
 
-        do {
-            jmpPiece = -1;
+void Checkers::Game::getMovesFromBoard_andPlayer(Checkers::Board const& board, unsigned short player, Checkers::MoveList& moveList) {
+    if(player) {
+        getMovesFromBoard<1>(board, moveList);
+    } else {
+        getMovesFromBoard<0>(board, moveList);
+    }
+}
 
-            xJmp = tempMove.xPath[0] + (0 < xDiff) - (xDiff < 0);
-            yJmp = tempMove.yPath[0] + (0 < yDiff) - (yDiff < 0);
 
-            for(i = 0; i < 12; i++) {
-                if(    tempBoard.pieces[opponent][i].xPos == xJmp
-                    && tempBoard.pieces[opponent][i].yPos == yJmp) {
-                    jmpPiece = i;
-                }
-            }
-            
-            // inconsistent board check
-            if(jmpPiece < 0) {
-                return board;
-            }
-                
-            // handle promotion
-            if(!board.pieces[move.player][srcPiece].isKing && tempMove.yPath[1] == 7 * opponent) {
-                tempBoard.pieces[move.player][srcPiece].isKing = true;
-            }
+bool Checkers::Game::hasCaptureFromBoard_andPlayer(Board const& board, unsigned short player) {
+    return (player ? getJumpersFromBoard<1>(board) : getJumpersFromBoard<0>(board)) != 0;
+}
 
-            // update the board
-            tempBoard.squares[tempMove.yPath[0]][tempMove.xPath[0]] = 4;
-            tempBoard.squares[yJmp][xJmp] = 4;
-            tempBoard.squares[tempMove.yPath[1]][tempMove.xPath[1]] = (int(tempBoard.pieces[move.player][srcPiece].isKing) << 1) | move.player;
-
-            // update the piece location
-            tempBoard.pieces[move.player][srcPiece].xPos = 0xFFU;
-            tempBoard.pieces[move.player][srcPiece].yPos = 0xFFU;
-            tempBoard.pieces[opponent][jmpPiece].xPos = 0xFFU;
-            tempBoard.pieces[opponent][jmpPiece].yPos = 0xFFU;
-            tempBoard.pieces[move.player][srcPiece].xPos = tempMove.xPath[1];
-            tempBoard.pieces[move.player][srcPiece].yPos = tempMove.yPath[1];
-
-            // return if promoted
-            if(!board.pieces[move.player][srcPiece].isKing && tempBoard.pieces[move.player][srcPiece].isKing) {
-                this->numMovesSinceCapture = 0;
-                return tempBoard;
-            }
 
-            // shift move path to the left
-            for(i = 0; tempMove.xPath[i] >= 0 && tempMove.xPath[i] <= 7 && tempMove.yPath[i] >= 0 && tempMove.yPath[i] <= 7; i++) {
-                tempMove.xPath[i] = tempMove.xPath[i + 1];
-                tempMove.yPath[i] = tempMove.yPath[i + 1];
-            }
-        } while(!(tempMove.xPath[0] > 7 || tempMove.yPath[0] > 7 || tempMove.xPath[1] > 7 || tempMove.yPath[1] > 7
-                || ((tempMove.xPath[0] + tempMove.yPath[0]) & 1) || ((tempMove.xPath[1] + tempMove.yPath[1]) & 1)
-                || tempBoard.squares[tempMove.yPath[1]][tempMove.xPath[1]] != 4)
-                  && (abs(xDiff = (tempMove.xPath[1] - tempMove.xPath[0])) == 2 && abs(yDiff = (tempMove.yPath[1] - tempMove.yPath[0])) == 2));
+// whether the move list would be empty, without building it
+bool Checkers::Game::hasMoveFromBoard_andPlayer(Board const& board, unsigned short player) {
+    return player ? (getJumpersFromBoard<1>(board) | getSteppersFromBoard<1>(board)) != 0
+                  : (getJumpersFromBoard<0>(board) | getSteppersFromBoard<0>(board)) != 0;
+}
 
-        this->numMovesSinceCapture = 0;
-        return tempBoard;
-    }
+
+// the number of simple moves, or with a capture pending, the number of first jumps (a multi-jump which
+// branches later counts once), again without building the move list
+int Checkers::Game::getMobilityFromBoard_andPlayer(Board const& board, unsigned short player) {
+    return player ? getMobilityFromBoard<1>(board) : getMobilityFromBoard<0>(board);
+}
 
 
-    // catch-all for all other invalid moves
-    else { 
-        return board;
+uint64_t Checkers::Game::getKeyFromBoard_andPlayer(Board const& board, unsigned short player) {
+    uint64_t key = player ? zobristKeys.playerTurn : 0;
+    uint32_t bits;
+    int i;
+
+    for(i = 0; i < 2; i++) {
+        for(bits = board.pieces[i]; bits; bits &= bits - 1) {
+            key ^= zobristKeys.pieces[i][__builtin_ctz(bits)];
+        }
     }
+    for(bits = board.kings; bits; bits &= bits - 1) {
+        key ^= zobristKeys.kings[__builtin_ctz(bits)];
+    }
+
+    return key;
 }
 
 
-// TODO: make the jumps section efficient (or at least clean up the code so it's more compact)
-std::vector<Checkers::Move> Checkers::Game::getMovesFromBoard_andPlayer(Checkers::Board const& board, unsigned short player) {
-    int i, j, k;
-    Checkers::Move tempMove;
-    Checkers::Piece tempPiece;    // we make a temp piece so we don't have to do pointer addition each time we get the piece
-    std::vector<Checkers::Move> moveList;
-    int xDest[2], yDest[2];
-    struct {
-        uint8_t x, y;             // x,y position of current square
-        uint8_t checked;          // variable for checking jump directions
-        bool descJump;            // one of the descendants made a jump (this way, we don't record invalid jumps)
-    } boardStack[13], node;
-    bool pieceJumped[8][8] = {0}; // map describing whether a piece was jumped
-    uint8_t depth;                // current depth of the move stack
-    uint8_t opponent = (~player) & 1;
+// only the squares touched by the move are hashed, and the player to move flips
+uint64_t Checkers::Game::getNextKeyFromMoveUndo(uint64_t key, MoveUndo const& undo) {
+    uint32_t bits;
 
-    tempMove.player = player;
+    key ^= zobristKeys.playerTurn;
+    key ^= zobristKeys.pieces[undo.player][undo.from] ^ zobristKeys.pieces[undo.player][undo.to];
 
+    if(undo.wasKing) {
+        key ^= zobristKeys.kings[undo.from] ^ zobristKeys.kings[undo.to];
+    } else if(undo.promoted) {
+        key ^= zobristKeys.kings[undo.to];
+    }
 
-    // first, check for jumps
-    for(i = 0; i < 12; i++) {
-        tempPiece = board.pieces[player][i];
-        tempMove.xPath[0] = tempPiece.xPos;
-        tempMove.yPath[0] = tempPiece.yPos;
+    for(bits = undo.captured; bits; bits &= bits - 1) {
+        key ^= zobristKeys.pieces[(~undo.player) & 1][__builtin_ctz(bits)];
+    }
+    for(bits = undo.capturedKings; bits; bits &= bits - 1) {
+        key ^= zobristKeys.kings[__builtin_ctz(bits)];
+    }
 
-        boardStack[0].x = tempPiece.xPos;
-        boardStack[0].y = tempPiece.yPos;
-        boardStack[0].checked = 0;
-        depth = 0;
+    return key;
+}
 
-        if(tempPiece.isKing) {
 
-            while(boardStack[0].checked != 0xFU || depth != 0) {
-                node = boardStack[depth];
+uint8_t Checkers::Game::getSquareFromBoard(Board const& board, uint8_t x, uint8_t y) {
+    uint32_t bit = 1U << (4 * y + x / 2);
 
-                // check top right
-                if(!(boardStack[depth].checked & 0x8U)) {
-                    boardStack[depth].checked |= 0x8U;
+    // white squares are always empty
+    if((x + y) & 1) {
+        return 4;
+    }
 
-                    if(    (node.x + 2) >= 0 && (node.x + 2) <= 7 && (node.y + 2) >= 0 && (node.y + 2) <= 7 // in range
-                        && board.squares[node.y + 1][node.x + 1] != 4              // jump square not empty
-                        && (board.squares[node.y + 1][node.x + 1] & 1) == opponent // jump square holds enemy piece
-                        && !pieceJumped[node.y + 1][node.x + 1]                    // piece wasn't already jumped
-                        && (board.squares[node.y + 2][node.x + 2] == 4             // dest square empty OR
-                            || (node.x + 2 == boardStack[0].x && node.y + 2 == boardStack[0].y))) { // dest square same as start square
+    for(uint8_t i = 0; i < 2; i++) {
+        if(board.pieces[i] & bit) {
+            return ((board.kings & bit) ? 2 : 0) | i;
+        }
+    }
 
+    return 4;
+}
 
-                        pieceJumped[node.y + 1][node.x + 1] = true; // we have jumped that piece
-                        depth++;
-                        boardStack[depth].x = node.x + 2;
-                        boardStack[depth].y = node.y + 2;
-                        boardStack[depth].checked = 0;
-                        boardStack[depth].descJump = false;
-                    }
-                }
-                
-                // check top left
-                else if(!(boardStack[depth].checked & 0x4U)) {
-                    boardStack[depth].checked |= 0x4U;
-
-                    if(    (node.x - 2) >= 0 && (node.x - 2) <= 7 && (node.y + 2) >= 0 && (node.y + 2) <= 7 // in range
-                        && board.squares[node.y + 1][node.x - 1] != 4              // jump square not empty
-                        && (board.squares[node.y + 1][node.x - 1] & 1) == opponent // jump square holds enemy piece
-                        && !pieceJumped[node.y + 1][node.x - 1]                    // piece wasn't already jumped
-                        && (board.squares[node.y + 2][node.x - 2] == 4             // dest square empty OR
-                            || (node.x - 2 == boardStack[0].x && node.y + 2 == boardStack[0].y))) { // dest square same as start square
-
-                        pieceJumped[node.y + 1][node.x - 1] = true; // we have jumped that piece
-                        depth++;
-                        boardStack[depth].x = node.x - 2;
-                        boardStack[depth].y = node.y + 2;
-                        boardStack[depth].checked = 0;
-                        boardStack[depth].descJump = false;
-                    }
-                }
-                
-                // check bottom left
-                else if(!(boardStack[depth].checked & 0x2U)) {
-                    boardStack[depth].checked |= 0x2U;
-
-                    if(    (node.x - 2) >= 0 && (node.x - 2) <= 7 && (node.y - 2) >= 0 && (node.y - 2) <= 7 // in range
-                        && board.squares[node.y - 1][node.x - 1] != 4              // jump square not empty
-                        && (board.squares[node.y - 1][node.x - 1] & 1) == opponent // jump square holds enemy piece
-                        && !pieceJumped[node.y - 1][node.x - 1]                    // piece wasn't already jumped
-                        && (board.squares[node.y - 2][node.x - 2] == 4             // dest square empty OR
-                            || (node.x - 2 == boardStack[0].x && node.y - 2 == boardStack[0].y))) { // dest square same as start square
-
-                        pieceJumped[node.y - 1][node.x - 1] = true; // we have jumped that piece
-                        depth++;
-                        boardStack[depth].x = node.x - 2;
-                        boardStack[depth].y = node.y - 2;
-                        boardStack[depth].checked = 0;
-                        boardStack[depth].descJump = false;
-                    }
-                }
-                
-                // check bottom right
-                else if(!(boardStack[depth].checked & 0x1U)) {
-                    boardStack[depth].checked |= 0x1U;
-
-                    if(    (node.x + 2) >= 0 && (node.x + 2) <= 7 && (node.y - 2) >= 0 && (node.y - 2) <= 7 // in range
-                        && board.squares[node.y - 1][node.x + 1] != 4              // jump square not empty
-                        && (board.squares[node.y - 1][node.x + 1] & 1) == opponent // jump square holds enemy piece
-                        && !pieceJumped[node.y - 1][node.x + 1]                    // piece wasn't already jumped
-                        && (board.squares[node.y - 2][node.x + 2] == 4             // dest square empty OR
-                            || (node.x + 2 == boardStack[0].x && node.y - 2 == boardStack[0].y))) { // dest square same as start square
-
-                        pieceJumped[node.y - 1][node.x + 1] = true; // we have jumped that piece
-                        depth++;
-                        boardStack[depth].x = node.x + 2;
-                        boardStack[depth].y = node.y - 2;
-                        boardStack[depth].checked = 0;
-                        boardStack[depth].descJump = false;
-                    }
-                }
-                
-                // everything has been checked already
-                // as long as our desc (if any) didn't make a jump, we should count the stack as a jump move
-                else {
-                    if(!boardStack[depth].descJump) {
-                        for(j = 1; j <= depth; j++) {
-                            tempMove.xPath[j] = boardStack[j].x;
-                            tempMove.yPath[j] = boardStack[j].y;
-                        }
 
-                        // only add the "move-ender" if we know that the move doesn't jump 12 pieces
-                        if(j < 13) {
-                            tempMove.xPath[j] = tempMove.yPath[j] = 0xFFU;
-                        }
-                        moveList.push_back(tempMove);
-                    }
+void Checkers::Game::setSquareOnBoard(Board& board, uint8_t x, uint8_t y, uint8_t square) {
+    uint32_t bit = 1U << (4 * y + x / 2);
 
-                    // if we're in here, a desc of our parent definitely made a jump
-                    boardStack[depth - 1].descJump = true;
-                    
-                    // remove jumped piece status
-                    pieceJumped[(node.y + boardStack[depth - 1].y) / 2][(node.x + boardStack[depth - 1].x) / 2] = false;
+    // pieces can only be placed on dark squares
+    if((x + y) & 1) {
+        return;
+    }
 
-                    depth--; // go up one
-                }
-            }
-        }
+    board.pieces[0] &= ~bit;
+    board.pieces[1] &= ~bit;
+    board.kings &= ~bit;
 
-        // not a king
-        else {
-            while(boardStack[0].checked != 0xCU || depth != 0) {
-                node = boardStack[depth];
-
-                // check (y-direction) right
-                if(!(boardStack[depth].checked & 0x8U)) {
-                    boardStack[depth].checked |= 0x8U;
-
-                    if(    (node.x + 2) >= 0 && (node.x + 2) <= 7 && (node.y + (4 * opponent - 2)) >= 0 && (node.y + (4 * opponent - 2)) <= 7 // in range
-                        && board.squares[node.y + (2 * opponent - 1)][node.x + 1] != 4              // jump square not empty
-                        && (board.squares[node.y + (2 * opponent - 1)][node.x + 1] & 1) == opponent // jump square holds enemy piece
-                        && !pieceJumped[node.y + (2 * opponent - 1)][node.x + 1]                    // piece wasn't already jumped
-                        && board.squares[node.y + (4 * opponent - 2)][node.x + 2] == 4) {           // dest square empty OR
-
-
-                        pieceJumped[node.y + (2 * opponent - 1)][node.x + 1] = true; // we have jumped that piece
-                        depth++;
-                        boardStack[depth].x = node.x + 2;
-                        boardStack[depth].y = node.y + (4 * opponent - 2);
-                        boardStack[depth].checked = 0;
-                        boardStack[depth].descJump = false;
-                    }
-                }
+    if(square < 4) {
+        board.pieces[square & 1] |= bit;
+        if(square & 2) {
+            board.kings |= bit;
+        }
+    }
+}
 
-                // check (y-direction) left
-                else if(!(boardStack[depth].checked & 0x4U)) {
-                    boardStack[depth].checked |= 0x4U;
 
-                    if(    (node.x - 2) >= 0 && (node.x - 2) <= 7 && (node.y + (4 * opponent - 2)) >= 0 && (node.y + (4 * opponent - 2)) <= 7 // in range
-                        && board.squares[node.y + (2 * opponent - 1)][node.x - 1] != 4              // jump square not empty
-                        && (board.squares[node.y + (2 * opponent - 1)][node.x - 1] & 1) == opponent // jump square holds enemy piece
-                        && !pieceJumped[node.y + (2 * opponent - 1)][node.x - 1]                    // piece wasn't already jumped
-                        && board.squares[node.y + (4 * opponent - 2)][node.x - 2] == 4) {           // dest square empty OR
+// the jumps are ordered by a depth-first search for a path which jumps every captured square
+// and ends on the destination square
+Checkers::MovePath Checkers::Game::getPathFromMove(Move const& move) {
+    Checkers::MovePath path;
+    struct {
+        uint8_t square;
+        uint8_t direction;        // next direction to try from the square
+        uint32_t jumped;          // bit of the piece jumped to reach the square
+    } pathStack[13];
+    uint32_t remaining = move.captures;
+    int i, depth = 0, direction, square;
+
+    path.player = move.player;
+    path.xPath[0] = path.yPath[0] = 0xFFU;
+
+    if(move.from > 31 || move.to > 31) {
+        return path;
+    }
 
+    pathStack[0].square = move.from;
+    pathStack[0].direction = move.captures ? 0 : 4;
 
-                        pieceJumped[node.y + (2 * opponent - 1)][node.x - 1] = true; // we have jumped that piece
-                        depth++;
-                        boardStack[depth].x = node.x - 2;
-                        boardStack[depth].y = node.y + (4 * opponent - 2);
-                        boardStack[depth].checked = 0;
-                        boardStack[depth].descJump = false;
-                    }
-                }
-                
-                // everything has been checked already
-                // as long as our desc (if any) didn't make a jump, we should count the stack as a jump move
-                else {
-                    if(!boardStack[depth].descJump) {
-                        for(j = 1; j <= depth; j++) {
-                            tempMove.xPath[j] = boardStack[j].x;
-                            tempMove.yPath[j] = boardStack[j].y;
-                        }
+    while(remaining || pathStack[depth].square != move.to) {
+        if(pathStack[depth].direction < 4) {
+            direction = pathStack[depth].direction++;
+            square = pathStack[depth].square;
 
-                        // only add the "move-ender" if we know that the move doesn't jump 12 pieces
-                        if(j < 13) {
-                            tempMove.xPath[j] = tempMove.yPath[j] = 0xFFU;
-                        }
-                        moveList.push_back(tempMove);
-                    }
+            if(squareTables::jumpBits[square][direction] && (squareTables::stepBits[square][direction] & remaining)) {
+                depth++;
+                pathStack[depth].square = __builtin_ctz(squareTables::jumpBits[square][direction]);
+                pathStack[depth].direction = 0;
+                pathStack[depth].jumped = squareTables::stepBits[square][direction];
+                remaining &= ~pathStack[depth].jumped;
+            }
+        }
 
-                    // if we're in here, a desc of our parent definitely made a jump
-                    boardStack[depth - 1].descJump = true;
-                    
-                    // remove jumped piece status
-                    pieceJumped[(node.y + boardStack[depth - 1].y) / 2][(node.x + boardStack[depth - 1].x) / 2] = false;
+        // a simple move (or a move whose jumps cannot be ordered) is printed from src to dest
+        else if(!depth) {
+            pathStack[++depth].square = move.to;
+            break;
+        }
 
-                    depth--; // go up one
-                }
-            }
+        else {
+            remaining |= pathStack[depth].jumped;
+            depth--;
         }
     }
 
-    // if no jumps were found, look for simple moves
-    if(!moveList.size()) {
-        for(i = 0; i < 12; i++) {
-            tempPiece = board.pieces[player][i];
-            tempMove.xPath[0] = tempPiece.xPos;
-            tempMove.yPath[0] = tempPiece.yPos;
-            tempMove.xPath[2] = tempMove.yPath[2] = 0xFFU;
-
-            xDest[0] = tempPiece.xPos - 1;
-            xDest[1] = tempPiece.xPos + 1;
-            yDest[0] = tempPiece.yPos - 1;
-            yDest[1] = tempPiece.yPos + 1;
-
-            if(tempPiece.isKing) {
-                for(j = 0; j < 2; j++) {
-                    for(k = 0; k < 2; k++) {
-                        if(    xDest[j] >= 0 && xDest[j] <= 7
-                            && yDest[k] >= 0 && yDest[k] <= 7
-                            && board.squares[yDest[k]][xDest[j]] & 4) {
-                            tempMove.xPath[1] = xDest[j];
-                            tempMove.yPath[1] = yDest[k];
-                            moveList.push_back(tempMove);
-                        }
-                    }
-                }
-            } else {
-                for(j = 0; j < 2; j++) {
-                    if(    xDest[j] >= 0 && xDest[j] <= 7
-                        && yDest[opponent] >= 0 && yDest[opponent] <= 7
-                        && board.squares[yDest[opponent]][xDest[j]] & 4) {
-                            tempMove.xPath[1] = xDest[j];
-                            tempMove.yPath[1] = yDest[opponent];
-                            moveList.push_back(tempMove);
-                    }
-                }
-            }
-        }
+    for(i = 0; i <= depth; i++) {
+        setMovePath(path, i, pathStack[i].square);
     }
-    
-    return moveList;
+    if(i < 13) {
+        path.xPath[i] = path.yPath[i] = 0xFFU;
+    }
+
+    return path;
 }
 
 
 std::string Checkers::Game::parseMove(Move const& move) {
     std::stringstream movePath;
+    Checkers::MovePath path = Checkers::Game::getPathFromMove(move);
     int i;
 
     for(i = 0; i < 13; i++) {
         // valid path check (out of range and white square)
-        if(move.xPath[i] > 7 || move.yPath[i] > 7 || 1 & (move.xPath[0] + move.yPath[0])) {
+        if(path.xPath[i] > 7 || path.yPath[i] > 7 || 1 & (path.xPath[0] + path.yPath[0])) {
             return movePath.str();
         }
 
         movePath << (i ? " -> " : "");
-        movePath << Checkers::columnMap[move.xPath[i]] << move.yPath[i] + 1;
+        movePath << Checkers::columnMap[path.xPath[i]] << path.yPath[i] + 1;
     }
     
     return movePath.str();
 }
 
 
+std::string Checkers::Game::getStringFromBoard_andPlayer(Board const& board, unsigned short player) {
+    std::string position(32, '-');
+    int i;
+
+    for(i = 0; i < 32; i++) {
+        if((board.pieces[0] | board.pieces[1]) & (1U << i)) {
+            position[i] = Checkers::squareMap[((board.kings >> i) & 1) << 1 | ((board.pieces[1] >> i) & 1)];
+        }
+    }
+
+    return position + " " + char('1' + (player & 1));
+}
+
+
+bool Checkers::Game::getBoardFromString(std::string const& position, Board& board, unsigned short& player) {
+    Checkers::Board tempBoard;
+    const char * square;
+    int i;
+
+    if(position.size() < 34 || position[32] != ' ' || (position[33] != '1' && position[33] != '2')) {
+        return false;
+    }
+
+    tempBoard.pieces[0] = tempBoard.pieces[1] = tempBoard.kings = 0;
+
+    for(i = 0; i < 32; i++) {
+        if(position[i] == '-') {
+            continue;
+        }
+
+        square = std::find(Checkers::squareMap, Checkers::squareMap + 4, position[i]);
+        if(square == Checkers::squareMap + 4) {
+            return false;
+        }
+
+        tempBoard.pieces[(square - Checkers::squareMap) & 1] |= 1U << i;
+        if((square - Checkers::squareMap) & 2) {
+            tempBoard.kings |= 1U << i;
+        }
+    }
+
+    board = tempBoard;
+    player = position[33] - '1';
+
+    return true;
+}
+
+
 uint8_t Checkers::Game::getPlayerTurn() {
     return this->playerTurn;
 }
 
 
+void Checkers::Game::setPlayerTurn(uint8_t playerTurn) {
+    this->playerTurn = playerTurn & 1;
+}
+
+
 Checkers::Time Checkers::Game::getMoveStartTime() {
     return this->moveStartTime;
 }
 
 
+void Checkers::Game::setMoveStartTime(Checkers::Time const& moveStartTime) {
+    this->moveStartTime = moveStartTime;
+}
+
+
+std::vector<uint64_t> const& Checkers::Game::getKeyHistory() {
+    return this->keyHistory;
+}
+
+
+void Checkers::Game::setKeyHistory(std::vector<uint64_t> const& keyHistory) {
+    this->keyHistory = keyHistory;
+}
+
+
+// the positions before a capture or a regular piece move can never come again, so they are dropped
+void Checkers::Game::addMoveToKeyHistory(std::vector<uint64_t>& keyHistory, Board const& board, Move const& move) {
+    if(move.from > 31 || move.captures || !(board.kings & (1U << move.from))) {
+        keyHistory.clear();
+    }
+
+    keyHistory.push_back(Checkers::Game::getKeyFromBoard_andPlayer(Checkers::Game::getNextBoardFromMove_andBoard(move, board), ~move.player & 1));
+}
+
+
 // TODO (optional): Add option to reverse the printed board
 void Checkers::Game::printCurrentBoard() {
     Checkers::Board board = this->getCurrentBoard();
     int i, j;
+    uint8_t square;
     int numReg[2] = {0};
     int numKing[2] = {0};
 
     for(i = 0; i < 2; i++) {
-        for(j = 0; j < 12; j++) {
-            if(board.pieces[i][j].xPos <= 7 && board.pieces[i][j].yPos <= 7) {
-                if(board.pieces[i][j].isKing) {
-                    numKing[i]++;
-                } else {
-                    numReg[i]++;
-                }
-            }
-        }
+        numKing[i] = __builtin_popcount(board.pieces[i] & board.kings);
+        numReg[i] = __builtin_popcount(board.pieces[i] & ~board.kings);
     }
 
     std::cout << std::endl;
@@ -1163,10 +2690,11 @@ void Checkers::Game::printCurrentBoard() {
                 std::cout << termcolor::on_grey << "   ";
             }
 
-            if(board.squares[i][j] & 1) {
-                std::cout << termcolor::yellow << Checkers::squareMap[board.squares[i][j]];
+            square = Checkers::Game::getSquareFromBoard(board, j, i);
+            if(square & 1) {
+                std::cout << termcolor::yellow << Checkers::squareMap[square];
             } else {
-                std::cout << termcolor::cyan << Checkers::squareMap[board.squares[i][j]];
+                std::cout << termcolor::cyan << Checkers::squareMap[square];
             }
             
             std::cout << "   ";
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cctype>
+#include <checkers.hpp>
+#include <climits>
+#include <engine.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+// BEGIN  Engine method definitions (in order of appearance in engine.hpp) //
+/////////////////////////////////////////////////////////////////////////////
+Checkers::Engine::Engine() {
+    this->board = this->game.getCurrentBoard();
+    this->playerTurn = 0;
+    this->timeRemaining = -1;
+    this->timeIncrement = 0;
+    this->output = &std::cout;
+    this->newGame();
+}
+
+
+void Checkers::Engine::run(std::istream& input, std::ostream& output) {
+    std::string line, command;
+
+    this->output = &output;
+
+    while(std::getline(input, line)) {
+        std::istringstream arguments(line);
+        command.clear();
+        arguments >> command;
+
+        if(command == "quit") {
+            break;
+        } else if(command == "isready") {
+            this->send("readyok");
+        } else if(command == "newgame") {
+            this->stopSearch();
+            this->newGame();
+        } else if(command == "position") {
+            this->stopSearch();
+            if(!this->setPosition(arguments)) {
+                this->send("error invalid position '" + line + "'");
+            }
+        } else if(command == "time") {
+            this->timeRemaining = this->timeIncrement = 0;
+            arguments >> this->timeRemaining >> this->timeIncrement;
+            this->timeRemaining /= 1000;
+            this->timeIncrement /= 1000;
+        } else if(command == "go") {
+            this->stopSearch();
+            this->startSearch(arguments);
+        } else if(command == "stop") {
+            this->stopSearch();
+        } else if(command == "log") {
+            this->stopSearch();
+            if(!this->openLog(arguments)) {
+                this->send("error could not open log '" + line + "'");
+            }
+        } else if(!command.empty()) {
+            this->send("error unknown command '" + command + "'");
+        }
+    }
+
+    this->stopSearch();
+}
+
+
+void Checkers::Engine::newGame() {
+    this->player = Checkers::Player(&this->game, true, 1);
+    this->player.setInfoCallback([this](Checkers::SearchInfo const& info) {
+        std::ostringstream line;
+
+        line << "info depth " << info.depth << " score ";
+        if(info.score == INT_MAX) {
+            line << "win";
+        } else if(info.score == INT_MIN) {
+            line << "loss";
+        } else {
+            line << info.score;
+        }
+        line << " nodes " << info.nodes << " nps " << (uint64_t) (info.nodes / std::max(info.seconds, 1e-6)) << " pv";
+        for(Checkers::Move const& move : info.principalVariation) {
+            line << " " << Checkers::Engine::getTextFromMove(move);
+        }
+
+        this->send(line.str());
+    });
+    this->player.setStatisticsCallback([this](Checkers::SearchStatistics const& statistics) {
+        if(this->log.is_open()) {
+            this->log << Checkers::Player::getJsonFromStatistics(statistics) << std::endl;
+        }
+    });
+}
+
+
+bool Checkers::Engine::setPosition(std::istringstream& arguments) {
+    Checkers::Board board;
+    Checkers::Move move;
+    unsigned short playerTurn;
+    std::string position, token;
+    std::vector<uint64_t> keyHistory;
+
+    arguments >> position;
+    if(position == "start") {
+        board = Checkers::Game::getStartBoard();
+        playerTurn = 0;
+    } else if(!(arguments >> token) || !Checkers::Game::getBoardFromString(position + " " + token, board, playerTurn)) {
+        return false;
+    }
+
+    // the moves also give the positions the search has to see as repetitions
+    keyHistory.push_back(Checkers::Game::getKeyFromBoard_andPlayer(board, playerTurn));
+    if(arguments >> token) {
+        if(token != "moves") {
+            return false;
+        }
+
+        while(arguments >> token) {
+            if(!Checkers::Engine::getMoveFromText(token, board, playerTurn, move)) {
+                return false;
+            }
+            Checkers::Game::addMoveToKeyHistory(keyHistory, board, move);
+            board = Checkers::Game::getNextBoardFromMove_andBoard(move, board);
+            playerTurn = (~playerTurn) & 1;
+        }
+    }
+
+    this->board = board;
+    this->playerTurn = playerTurn;
+    this->game.setCurrentBoard(board);
+    this->game.setPlayerTurn(playerTurn);
+    this->game.setKeyHistory(keyHistory);
+
+    return true;
+}
+
+
+// without a move time the time manager works from the clock, or the search takes a second if there is none
+void Checkers::Engine::startSearch(std::istringstream& arguments) {
+    std::string token;
+    double moveTime = -1;
+    int depth = 49;
+    uint64_t nodes = 0;
+    bool infinite = false;
+
+    while(arguments >> token) {
+        if(token == "depth") {
+            arguments >> depth;
+        } else if(token == "nodes") {
+            arguments >> nodes;
+        } else if(token == "movetime") {
+            arguments >> moveTime;
+            moveTime /= 1000;
+        } else if(token == "infinite") {
+            infinite = true;
+        }
+    }
+
+    if(infinite || ((depth < 49 || nodes) && moveTime < 0)) {
+        this->player.setTimeLimit(1e9);
+    } else if(moveTime < 0 && this->timeRemaining >= 0) {
+        this->player.setGameTime(this->timeRemaining, this->timeIncrement);
+    } else {
+        this->player.setTimeLimit(moveTime < 0 ? 1 : moveTime);
+    }
+    this->player.setDepthLimit(depth);
+    this->player.setNodeLimit(nodes);
+    this->player.clearStopRequest();
+
+    this->searchThread = std::thread([this]() {
+        Checkers::Move move;
+
+        this->game.setMoveStartTime(Checkers::Clock::now());
+        move = this->player.makeMove(this->board);
+
+        this->send("bestmove " + (move.from > 31 ? std::string("none") : Checkers::Engine::getTextFromMove(move)));
+    });
+}
+
+
+void Checkers::Engine::stopSearch() {
+    if(this->searchThread.joinable()) {
+        this->player.stopSearch();
+        this->searchThread.join();
+    }
+}
+
+
+// the log is replaced by the given file, or closed without one
+bool Checkers::Engine::openLog(std::istringstream& arguments) {
+    std::string filePath;
+
+    this->log.close();
+    this->log.clear();
+    if(!(arguments >> filePath)) {
+        return true;
+    }
+
+    this->log.open(filePath.c_str());
+
+    return this->log.is_open();
+}
+
+
+void Checkers::Engine::send(std::string const& line) {
+    std::lock_guard<std::mutex> lock(this->outputMutex);
+    *this->output << line << std::endl;
+}
+
+
+std::string Checkers::Engine::getTextFromMove(Move const& move) {
+    Checkers::MovePath path = Checkers::Game::getPathFromMove(move);
+    std::string text;
+    int i;
+
+    for(i = 0; i < 13 && path.xPath[i] <= 7 && path.yPath[i] <= 7; i++) {
+        if(i) {
+            text += move.captures ? 'x' : '-';
+        }
+        text += (char) std::tolower(Checkers::columnMap[path.xPath[i]]);
+        text += (char) ('1' + path.yPath[i]);
+    }
+
+    return text;
+}
+
+
+bool Checkers::Engine::getMoveFromText(std::string const& text, Board const& board, unsigned short player, Move& move) {
+    Checkers::MoveList moveList;
+    std::string lowerText = text;
+    int i;
+
+    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+
+    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+    for(i = 0; i < moveList.size; i++) {
+        if(Checkers::Engine::getTextFromMove(moveList.moves[i]) == lowerText) {
+            move = moveList.moves[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+////////////////////////////////////
+// END  Engine method definitions //
+////////////////////////////////////
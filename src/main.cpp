@@ -1,8 +1,12 @@
+#include <benchmark.hpp>
 #include <checkers.hpp>
 #include <cstdlib>
+#include <ctime>
+#include <engine.hpp>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <match.hpp>
 #include <termcolor.hpp>
 
 
@@ -10,6 +14,9 @@ int main(int argc, char ** argv) {
 
     using namespace Checkers;
 
+    // seeded once for the process, since games are also made on several threads at once (book moves use std::rand)
+    std::srand(std::time(0));
+
     Game checkers = Game();
     std::string loadGame;          // will a game be loaded?
     std::string savedGameFilePath; // the path of the saved game file
@@ -17,10 +24,63 @@ int main(int argc, char ** argv) {
     std::string playerOneComputer; // is Player 1 a computer?
     std::string playerTwoComputer; // is Player 2 a computer?
     std::string computerTimeLimit; // what is the computer time limit?
+    std::string computerPonder;    // will the computer think on its opponent's time?
+    std::string logSearches;       // will the computer's searches be logged?
+    std::string logFilePath;       // the path of the search log file
     std::string playerFirstMove;   // which player will move first?
     std::string confirmParams;     // confirm the parameters with the user
 
 
+    // non-interactive modes
+    if(argc > 1) {
+        std::string mode = argv[1];
+
+        if(mode == "scaling") {
+            Benchmark::reportThreadScaling(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 12);
+        } else if(mode == "bench") {
+            Benchmark::runBench(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 12);
+        } else if(mode == "evaluation") {
+            return Benchmark::runEvaluation(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 4) ? 0 : 1;
+        } else if(mode == "movecheck") {
+            return Benchmark::runMoveCheck(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 6) ? 0 : 1;
+        } else if(mode == "tablebase") {
+            return Tablebase::generate(  tablebaseFilePath
+                                       , argc > 2 ? std::strtol(argv[2], nullptr, 10) : 4
+                                       , argc > 3 ? std::strtol(argv[3], nullptr, 10) : searchThreads) ? 0 : 1;
+        } else if(mode == "book") {
+            return OpeningBook::generate(  openingBookFilePath
+                                         , argc > 2 ? std::strtol(argv[2], nullptr, 10) : 100
+                                         , argc > 3 ? std::strtol(argv[3], nullptr, 10) : 10
+                                         , argc > 4 ? std::strtol(argv[4], nullptr, 10) : 16
+                                         , argc > 5 ? std::strtol(argv[5], nullptr, 10) : searchThreads) ? 0 : 1;
+        } else if(mode == "match") {
+            MatchSettings settings = Match::getDefaultSettings();
+            for(int i = 2; i < argc; i++) {
+                if(!Match::setSetting(settings, argv[i])) {
+                    std::cout << "Unknown match setting '" << argv[i] << "'" << std::endl;
+                    return 1;
+                }
+            }
+            return Match::run(settings) ? 0 : 1;
+        } else if(mode == "engine") {
+            Engine engine;
+            engine.run(std::cin, std::cout);
+        } else if(mode == "perft") {
+            return Benchmark::runPerft(  "data/perft.txt"
+                                       , argc > 2 ? std::strtol(argv[2], nullptr, 10) : 8
+                                       , argc > 3 ? std::strtol(argv[3], nullptr, 10) : 1
+                                       , argc > 4 ? std::strtol(argv[4], nullptr, 10) : 0) ? 0 : 1;
+        } else {
+            std::cout << "Unknown mode '" << mode << "'" << std::endl;
+            std::cout << "Usage: " << argv[0] << " [scaling [depth] | bench [depth] | evaluation [depth] | movecheck [depth] | perft [depth [threads [hash MB]]] | tablebase [pieces [threads]]"
+                      << " | book [games [depth [plies [threads]]]] | match [setting=value ...] | engine]" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+
     while(confirmParams != "y") {
 
         while((std::cout << "Would you like to load a saved game? (y / n): ")
@@ -50,6 +110,20 @@ int main(int argc, char ** argv) {
                 std::cin.clear();
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
+            while((std::cout << " > Should the computer think on its opponent's time? (y / n): ")
+                    && (!(std::cin >> computerPonder) || (computerPonder != "y" && computerPonder != "n"))) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+            while((std::cout << " > Would you like to log the statistics of the computer's searches? (y / n): ")
+                    && (!(std::cin >> logSearches) || (logSearches != "y" && logSearches != "n"))) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+            if(logSearches == "y") {
+                std::cout << "    > Please enter a log file path: ";
+                std::cin >> logFilePath;
+            }
         }
 
 
@@ -70,6 +144,10 @@ int main(int argc, char ** argv) {
         std::cout << " > Player 2 " << (playerTwoComputer == "y" ? "will" : "will not") << " be a computer" << std::endl;
         if(computerTimeLimit != "") {
             std::cout << " > Time limit for computer movement will be " << std::strtoll(computerTimeLimit.c_str(), nullptr, 10) << " seconds" << std::endl;
+            std::cout << " > Computer " << (computerPonder == "y" ? "will" : "will not") << " think on its opponent's time" << std::endl;
+            if(logSearches == "y") {
+                std::cout << " > Computer searches will be logged to '" << logFilePath << "'" << std::endl;
+            }
         }
         std::cout << " > Player " << playerFirstMove << " will move first" << std::endl;
 
@@ -86,10 +164,15 @@ int main(int argc, char ** argv) {
         checkers.load(savedGameFilePath);
     }
 
+    if(logSearches == "y") {
+        checkers.setLogFilePath(logFilePath);
+    }
+
     checkers.start(  playerOneComputer == "y" ? true : false
                    , playerTwoComputer == "y" ? true : false
                    , playerFirstMove == "1" ? 0 : 1
-                   , static_cast<double>(std::strtoll(computerTimeLimit.c_str(), nullptr, 10)));
+                   , static_cast<double>(std::strtoll(computerTimeLimit.c_str(), nullptr, 10))
+                   , computerPonder == "y" ? true : false);
 
     return 0;
 }
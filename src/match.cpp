@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <atomic>
+#include <checkers.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <match.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+/////////////////////////////////////
+// BEGIN  Match helper definitions //
+/////////////////////////////////////
+static inline double getEloFromScore(double score) {
+    score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+    return -400 * std::log10(1 / score - 1);
+}
+
+
+static inline double getScoreFromElo(double elo) {
+    return 1 / (1 + std::pow(10, -elo / 400));
+}
+
+
+// results of the first engine, with the statistics derived from them
+typedef struct {
+    unsigned int wins;
+    unsigned int draws;
+    unsigned int losses;
+    double score;    // mean score per game
+    double variance; // variance of the score of a game
+    double elo;
+    double eloError; // half width of the 95% confidence interval
+    double llr;      // log-likelihood ratio of elo1 over elo0
+} MatchResults;
+
+
+// the log-likelihood ratio uses the normal approximation of the game results, which needs a few games
+static void updateMatchResults(MatchResults& results, Checkers::MatchSettings const& settings) {
+    const unsigned int minGames = 16;
+    double games = results.wins + results.draws + results.losses;
+    double score0 = getScoreFromElo(settings.elo0);
+    double score1 = getScoreFromElo(settings.elo1);
+    double error;
+
+    results.score = (results.wins + 0.5 * results.draws) / games;
+    results.variance = (  results.wins * (1 - results.score) * (1 - results.score)
+                        + results.draws * (0.5 - results.score) * (0.5 - results.score)
+                        + results.losses * results.score * results.score) / games;
+
+    error = 1.96 * std::sqrt(results.variance / games);
+    results.elo = getEloFromScore(results.score);
+    results.eloError = (getEloFromScore(results.score + error) - getEloFromScore(results.score - error)) / 2;
+
+    if(games < minGames || results.variance <= 0) {
+        results.llr = 0;
+    } else {
+        results.llr = games * (score1 - score0) * (2 * results.score - score0 - score1) / (2 * results.variance);
+    }
+}
+
+
+static void printMatchResults(MatchResults const& results, double lowerBound, double upperBound) {
+    std::cout << "games " << std::setw(6) << results.wins + results.draws + results.losses
+              << "   W " << std::setw(5) << results.wins << "  D " << std::setw(5) << results.draws
+              << "  L " << std::setw(5) << results.losses
+              << std::fixed << std::setprecision(1)
+              << "   Elo " << std::setw(7) << results.elo << " +/- " << std::setw(5) << results.eloError
+              << std::setprecision(2)
+              << "   LLR " << std::setw(6) << results.llr << " [" << lowerBound << ", " << upperBound << "]" << std::endl;
+}
+///////////////////////////////////
+// END  Match helper definitions //
+///////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////////////
+// BEGIN  Match method definitions (in order of appearance in match.hpp) //
+///////////////////////////////////////////////////////////////////////////
+Checkers::MatchSettings Checkers::Match::getDefaultSettings() {
+    Checkers::MatchSettings settings;
+
+    settings.openingsFilePath = "data/openings.txt";
+    settings.logFilePath = "";
+    settings.games = 1000;
+    settings.threads = Checkers::searchThreads;
+    settings.engines[0].timeLimit = settings.engines[1].timeLimit = 0.5;
+    settings.engines[0].nodeLimit = settings.engines[1].nodeLimit = 0;
+    settings.engines[0].depthLimit = settings.engines[1].depthLimit = 49;
+    settings.engines[0].ponder = settings.engines[1].ponder = false;
+    settings.elo0 = 0;
+    settings.elo1 = 10;
+    settings.alpha = 0.05;
+    settings.beta = 0.05;
+
+    return settings;
+}
+
+
+// time, nodes, depth and ponder (0 or 1) set both engines; time1, time2, nodes1, ... set one of them
+bool Checkers::Match::setSetting(Checkers::MatchSettings& settings, std::string const& argument) {
+    size_t separator = argument.find('=');
+    std::string name = argument.substr(0, separator);
+    std::string value = separator == std::string::npos ? "" : argument.substr(separator + 1);
+    int engine = -1, i;
+
+    if(separator == std::string::npos || value.empty()) {
+        return false;
+    }
+
+    if(name.back() == '1' || name.back() == '2') {
+        engine = name.back() - '1';
+        name.pop_back();
+    }
+
+    for(i = 0; i < 2; i++) {
+        if(engine != -1 && engine != i) {
+            continue;
+        }
+
+        if(name == "time") {
+            settings.engines[i].timeLimit = std::strtod(value.c_str(), nullptr);
+        } else if(name == "nodes") {
+            settings.engines[i].nodeLimit = std::strtoull(value.c_str(), nullptr, 10);
+        } else if(name == "depth") {
+            settings.engines[i].depthLimit = std::strtol(value.c_str(), nullptr, 10);
+        } else if(name == "ponder") {
+            settings.engines[i].ponder = std::strtol(value.c_str(), nullptr, 10) != 0;
+        } else if(engine != -1) {
+            return false;
+        } else if(name == "openings") {
+            settings.openingsFilePath = value;
+            break;
+        } else if(name == "log") {
+            settings.logFilePath = value;
+            break;
+        } else if(name == "games") {
+            settings.games = std::strtoul(value.c_str(), nullptr, 10);
+            break;
+        } else if(name == "threads") {
+            settings.threads = std::max(1UL, std::strtoul(value.c_str(), nullptr, 10));
+            break;
+        } else if(name == "elo0") {
+            settings.elo0 = std::strtod(value.c_str(), nullptr);
+            break;
+        } else if(name == "elo1") {
+            settings.elo1 = std::strtod(value.c_str(), nullptr);
+            break;
+        } else if(name == "alpha") {
+            settings.alpha = std::strtod(value.c_str(), nullptr);
+            break;
+        } else if(name == "beta") {
+            settings.beta = std::strtod(value.c_str(), nullptr);
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// game 2i plays opening i with the first engine to move, and game 2i + 1 with the second; every search
+// runs on one thread, so that as many games as there are threads are played at once
+bool Checkers::Match::run(Checkers::MatchSettings const& settings) {
+    const unsigned int reportInterval = 10;
+    std::ifstream file(settings.openingsFilePath);
+    std::ofstream log;
+    std::mutex logMutex;
+    std::vector<std::string> openings;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned int> nextGame(0);
+    std::atomic<bool> stop(false);
+    std::mutex resultsMutex;
+    MatchResults results = {};
+    std::string line;
+    Checkers::Board board;
+    unsigned short playerTurn;
+    double lowerBound = std::log(settings.beta / (1 - settings.alpha));
+    double upperBound = std::log((1 - settings.beta) / settings.alpha);
+    unsigned int i;
+
+    while(std::getline(file, line)) {
+        if(!line.empty() && line[0] != '#' && Checkers::Game::getBoardFromString(line, board, playerTurn)) {
+            openings.push_back(line.substr(0, 34));
+        }
+    }
+
+    if(openings.empty()) {
+        std::cout << "Could not read any openings from '" << settings.openingsFilePath << "'" << std::endl;
+        return false;
+    }
+
+    if(!settings.logFilePath.empty()) {
+        log.open(settings.logFilePath);
+        if(!log.is_open()) {
+            std::cout << "Could not open log file '" << settings.logFilePath << "'" << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "Playing " << settings.games << " games from " << openings.size() << " openings on "
+              << settings.threads << " thread(s)" << std::endl;
+    for(i = 0; i < 2; i++) {
+        std::cout << " > Engine " << i + 1 << ": " << settings.engines[i].timeLimit << " s";
+        if(settings.engines[i].nodeLimit) {
+            std::cout << ", " << settings.engines[i].nodeLimit << " nodes";
+        }
+        std::cout << ", depth " << settings.engines[i].depthLimit << " per move";
+        if(settings.engines[i].ponder) {
+            std::cout << ", pondering";
+        }
+        std::cout << std::endl;
+
+        if(settings.engines[i].timeLimit <= Checkers::timeRemainingThreshold) {
+            std::cout << "   (the search needs more than " << Checkers::timeRemainingThreshold
+                      << " s per move; engine " << i + 1 << " will play its first move)" << std::endl;
+        }
+    }
+    std::cout << " > SPRT: elo0 " << settings.elo0 << ", elo1 " << settings.elo1
+              << ", alpha " << settings.alpha << ", beta " << settings.beta << std::endl;
+
+    auto worker = [&]() {
+        Checkers::Board board;
+        unsigned short playerTurn;
+        unsigned int game;
+        int engine, winner;
+
+        while(!stop && (game = nextGame++) < settings.games) {
+            Checkers::Game checkers;
+            Checkers::Game::getBoardFromString(openings[(game / 2) % openings.size()], board, playerTurn);
+            checkers.setCurrentBoard(board);
+
+            // the engine to move from the opening alternates between the games of a pair
+            Checkers::Player players[2];
+            for(engine = 0; engine < 2; engine++) {
+                Checkers::Player& player = players[engine == (int) (game & 1) ? playerTurn : ~playerTurn & 1];
+                player = Checkers::Player(&checkers, true, settings.engines[engine].timeLimit);
+                player.setDepthLimit(settings.engines[engine].depthLimit);
+                player.setNodeLimit(settings.engines[engine].nodeLimit);
+                player.setThreadCount(1);
+                player.setPonder(settings.engines[engine].ponder);
+
+                // each record is wrapped with the game and the engine which searched
+                if(log.is_open()) {
+                    player.setStatisticsCallback([&log, &logMutex, game, engine](Checkers::SearchStatistics const& statistics) {
+                        std::string record = Checkers::Player::getJsonFromStatistics(statistics);
+                        std::lock_guard<std::mutex> lock(logMutex);
+                        log << "{\"game\":" << game + 1 << ",\"engine\":" << engine + 1 << ",\"search\":" << record << "}\n";
+                    });
+                }
+            }
+
+            winner = checkers.play(players[0], players[1], playerTurn);
+
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            if(winner == -1) {
+                results.draws++;
+            } else if((winner == playerTurn) == !(game & 1)) {
+                results.wins++;
+            } else {
+                results.losses++;
+            }
+
+            updateMatchResults(results, settings);
+            if((results.wins + results.draws + results.losses) % reportInterval == 0) {
+                printMatchResults(results, lowerBound, upperBound);
+            }
+
+            if(!stop && (results.llr <= lowerBound || results.llr >= upperBound)) {
+                stop = true;
+            }
+        }
+    };
+
+    for(i = 1; i < settings.threads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << std::endl << "Final result" << std::endl;
+    printMatchResults(results, lowerBound, upperBound);
+
+    if(results.llr >= upperBound) {
+        std::cout << "SPRT: H1 accepted (Elo difference of at least " << settings.elo1 << ")" << std::endl;
+    } else if(results.llr <= lowerBound) {
+        std::cout << "SPRT: H0 accepted (Elo difference of at most " << settings.elo0 << ")" << std::endl;
+    } else {
+        std::cout << "SPRT: inconclusive" << std::endl;
+    }
+
+    return true;
+}
+///////////////////////////////////
+// END  Match method definitions //
+///////////////////////////////////
@@ -0,0 +1,487 @@
+#include <algorithm>
+#include <atomic>
+#include <checkers.hpp>
+#include <cstdint>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+
+/////////////////////////////////////////
+// BEGIN  Tablebase helper definitions //
+/////////////////////////////////////////
+// a tablebase file is a header, then the file offset of every material class (indexed by the number
+// of regular pieces and kings of each player), then the classes, with four 2-bit results per byte
+typedef struct {
+    uint32_t magic;
+    uint32_t maxPieces;
+} TablebaseHeader;
+
+static const uint32_t tablebaseMagic = 0x31425443U; // "CTB1"
+static const int tablebaseMaxPieces = 5;             // keeps the largest class in memory while it is worked out
+
+// regular pieces never stand on the row where they would be crowned
+static const uint32_t crownRows[2] = {
+      0xF0000000U // Player 1 (row 8)
+    , 0x0000000FU // Player 2 (row 1)
+};
+
+
+// binomial coefficients, for numbering the sets of squares a group of pieces stands on
+static struct Binomials {
+    uint64_t values[33][13];
+
+    Binomials() {
+        int n, k;
+
+        for(n = 0; n <= 32; n++) {
+            this->values[n][0] = 1;
+            for(k = 1; k <= 12; k++) {
+                this->values[n][k] = n ? this->values[n - 1][k - 1] + this->values[n - 1][k] : 0;
+            }
+        }
+    }
+} binomials;
+
+
+// number of regular pieces and kings of each player, with the size of each group's set of squares
+typedef struct {
+    int counts[4];     // Player 1 men, Player 1 kings, Player 2 men, Player 2 kings
+    uint64_t sizes[4];
+    uint64_t size;     // positions for one player to move
+} MaterialClass;
+
+
+static inline void setMaterialClass(MaterialClass& material, int m0, int k0, int m1, int k1) {
+    int i;
+
+    material.counts[0] = m0;
+    material.counts[1] = k0;
+    material.counts[2] = m1;
+    material.counts[3] = k1;
+
+    material.size = 1;
+    for(i = 0; i < 4; i++) {
+        material.sizes[i] = binomials.values[32][material.counts[i]];
+        material.size *= material.sizes[i];
+    }
+}
+
+
+static inline void getGroupsFromBoard(Checkers::Board const& board, uint32_t * groups) {
+    groups[0] = board.pieces[0] & ~board.kings;
+    groups[1] = board.pieces[0] & board.kings;
+    groups[2] = board.pieces[1] & ~board.kings;
+    groups[3] = board.pieces[1] & board.kings;
+}
+
+
+static inline int getClassNumber(int maxPieces, uint32_t const * groups) {
+    int i, number = 0;
+
+    for(i = 0; i < 4; i++) {
+        number = number * (maxPieces + 1) + __builtin_popcount(groups[i]);
+    }
+
+    return number;
+}
+
+
+// colex rank of a set of squares: the sum of C(square, i) over its i-th lowest square
+static inline uint64_t getRankFromSquares(uint32_t squares) {
+    uint64_t rank = 0;
+    int i;
+
+    for(i = 1; squares; squares &= squares - 1, i++) {
+        rank += binomials.values[__builtin_ctz(squares)][i];
+    }
+
+    return rank;
+}
+
+
+static inline uint32_t getSquaresFromRank(uint64_t rank, int count) {
+    uint32_t squares = 0;
+    int i, square = 31;
+
+    for(i = count; i > 0; i--) {
+        while(binomials.values[square][i] > rank) {
+            square--;
+        }
+        rank -= binomials.values[square][i];
+        squares |= 1U << square;
+    }
+
+    return squares;
+}
+
+
+static inline uint64_t getIndexFromGroups(MaterialClass const& material, uint32_t const * groups, unsigned short player) {
+    uint64_t index = player;
+    int i;
+
+    for(i = 0; i < 4; i++) {
+        index = index * material.sizes[i] + getRankFromSquares(groups[i]);
+    }
+
+    return index;
+}
+
+
+// false if the index stands for no legal position (pieces sharing a square, or uncrowned men on the crowning row)
+static inline bool getBoardFromIndex(MaterialClass const& material, uint64_t index, Checkers::Board& board, unsigned short& player) {
+    uint32_t groups[4];
+    int i;
+
+    for(i = 3; i >= 0; i--) {
+        groups[i] = getSquaresFromRank(index % material.sizes[i], material.counts[i]);
+        index /= material.sizes[i];
+    }
+    player = index;
+
+    if(    __builtin_popcount(groups[0] | groups[1] | groups[2] | groups[3])
+               != material.counts[0] + material.counts[1] + material.counts[2] + material.counts[3]
+        || (groups[0] & crownRows[0]) || (groups[2] & crownRows[1])) {
+        return false;
+    }
+
+    board.pieces[0] = groups[0] | groups[1];
+    board.pieces[1] = groups[2] | groups[3];
+    board.kings = groups[1] | groups[3];
+
+    return true;
+}
+
+
+// result stored for a board in a tablebase image (the finished classes of a tablebase being generated, or a file)
+static inline Checkers::TablebaseResult probeImage(  uint8_t const * image
+                                                   , uint64_t const * offsets
+                                                   , int maxPieces
+                                                   , Checkers::Board const& board
+                                                   , unsigned short player) {
+    MaterialClass material;
+    uint32_t groups[4];
+    uint64_t index;
+    int number;
+
+    if(    !board.pieces[0] || !board.pieces[1]
+        || __builtin_popcount(board.pieces[0] | board.pieces[1]) > maxPieces) {
+        return Checkers::tablebaseUnknown;
+    }
+
+    getGroupsFromBoard(board, groups);
+    number = getClassNumber(maxPieces, groups);
+    if(!offsets[number]) {
+        return Checkers::tablebaseUnknown;
+    }
+
+    setMaterialClass(  material
+                     , __builtin_popcount(groups[0]), __builtin_popcount(groups[1])
+                     , __builtin_popcount(groups[2]), __builtin_popcount(groups[3]));
+    index = getIndexFromGroups(material, groups, player);
+
+    return (Checkers::TablebaseResult) ((image[offsets[number] + (index >> 2)] >> (2 * (index & 3))) & 3);
+}
+
+
+// split [0, count) among the threads in chunks
+static void runInParallel(unsigned int numThreads, uint64_t count, std::function<void(uint64_t, uint64_t)> const& work) {
+    const uint64_t chunkSize = 1 << 14;
+    std::atomic<uint64_t> nextChunk(0);
+    std::vector<std::thread> threads;
+    unsigned int i;
+
+    auto worker = [&]() {
+        uint64_t begin;
+        while((begin = chunkSize * nextChunk++) < count) {
+            work(begin, std::min(begin + chunkSize, count));
+        }
+    };
+
+    for(i = 1; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+}
+///////////////////////////////////////
+// END  Tablebase helper definitions //
+///////////////////////////////////////
+
+
+
+//////////////////////////////////////////////////////////////////////////////////
+// BEGIN  Tablebase method definitions (in order of appearance in checkers.hpp) //
+//////////////////////////////////////////////////////////////////////////////////
+Checkers::Tablebase::Tablebase() {
+    this->offsets = nullptr;
+    this->maxPieces = 0;
+}
+
+
+// every class is worked out after the classes its captures and crownings lead to: by piece count, then
+// by number of regular pieces. within a class, a position is a win once a move leads to a loss, and a
+// loss once every move leads to a win; passes over the class repeat until nothing changes, and the
+// positions left are draws (the move limit is not taken into account)
+bool Checkers::Tablebase::generate(std::string const& filePath, int maxPieces, unsigned int numThreads) {
+    // results while a class is worked out; the positions still unknown at the end are draws,
+    // so the results are packed into the file as they are
+    enum : uint8_t {
+          unknown = Checkers::tablebaseDraw
+        , win = Checkers::tablebaseWin
+        , loss = Checkers::tablebaseLoss
+        , invalid = Checkers::tablebaseUnknown
+    };
+    std::vector<MaterialClass> materials;
+    std::vector<uint64_t> offsets;
+    std::vector<uint8_t> image;
+    std::vector<uint8_t> results;
+    MaterialClass material;
+    TablebaseHeader header;
+    uint64_t i, counts[4];
+    std::atomic<uint64_t> changed;
+    int m0, k0, m1, k1, passes;
+    double seconds;
+    Checkers::Time ti;
+
+    maxPieces = std::min(std::max(maxPieces, 2), tablebaseMaxPieces);
+    numThreads = std::max(1U, numThreads);
+
+    for(m0 = 0; m0 <= maxPieces; m0++) {
+        for(k0 = 0; m0 + k0 <= maxPieces; k0++) {
+            for(m1 = 0; m0 + k0 + m1 <= maxPieces; m1++) {
+                for(k1 = 0; m0 + k0 + m1 + k1 <= maxPieces; k1++) {
+                    if(m0 + k0 && m1 + k1) {
+                        setMaterialClass(material, m0, k0, m1, k1);
+                        materials.push_back(material);
+                    }
+                }
+            }
+        }
+    }
+
+    std::stable_sort(materials.begin(), materials.end(), [](MaterialClass const& a, MaterialClass const& b) {
+        int piecesA = a.counts[0] + a.counts[1] + a.counts[2] + a.counts[3];
+        int piecesB = b.counts[0] + b.counts[1] + b.counts[2] + b.counts[3];
+        return piecesA != piecesB ? piecesA < piecesB : a.counts[0] + a.counts[2] < b.counts[0] + b.counts[2];
+    });
+
+    header.magic = tablebaseMagic;
+    header.maxPieces = maxPieces;
+    offsets.assign((maxPieces + 1) * (maxPieces + 1) * (maxPieces + 1) * (maxPieces + 1), 0);
+    image.resize(sizeof(header) + offsets.size() * sizeof(uint64_t));
+
+    std::cout << "Generating the tablebase for up to " << maxPieces << " pieces with " << numThreads << " thread(s)" << std::endl;
+    std::cout << std::setw(16) << "class" << std::setw(12) << "positions" << std::setw(12) << "wins"
+              << std::setw(12) << "losses" << std::setw(12) << "draws" << std::setw(8) << "passes"
+              << std::setw(10) << "time (s)" << std::endl;
+
+    for(MaterialClass const& current : materials) {
+        ti = Checkers::Clock::now();
+        results.assign(2 * current.size, unknown);
+        passes = 0;
+
+        do {
+            changed = 0;
+            passes++;
+
+            runInParallel(numThreads, results.size(), [&](uint64_t begin, uint64_t end) {
+                Checkers::Board board, nextBoard;
+                Checkers::MoveList moveList;
+                Checkers::MoveUndo undo;
+                uint32_t groups[4];
+                uint64_t index, numChanged = 0;
+                unsigned short player;
+                uint8_t result, nextResult;
+                bool allWins;
+                int j;
+
+                for(index = begin; index < end; index++) {
+                    if(__atomic_load_n(&results[index], __ATOMIC_RELAXED) != unknown) {
+                        continue;
+                    }
+
+                    if(!getBoardFromIndex(current, index, board, player)) {
+                        __atomic_store_n(&results[index], (uint8_t) invalid, __ATOMIC_RELAXED);
+                        continue;
+                    }
+
+                    Checkers::Game::getMovesFromBoard_andPlayer(board, player, moveList);
+                    result = moveList.size ? unknown : loss;
+                    allWins = true;
+
+                    for(j = 0; j < moveList.size && result == unknown; j++) {
+                        nextBoard = board;
+                        Checkers::Game::makeMoveOnBoard(moveList.moves[j], nextBoard, undo);
+
+                        // a move taking the last opposing piece wins outright
+                        if(!nextBoard.pieces[~player & 1]) {
+                            result = win;
+                            break;
+                        }
+
+                        getGroupsFromBoard(nextBoard, groups);
+                        if(    (int) __builtin_popcount(groups[0]) == current.counts[0]
+                            && (int) __builtin_popcount(groups[1]) == current.counts[1]
+                            && (int) __builtin_popcount(groups[2]) == current.counts[2]
+                            && (int) __builtin_popcount(groups[3]) == current.counts[3]) {
+                            nextResult = __atomic_load_n(&results[getIndexFromGroups(current, groups, ~player & 1)], __ATOMIC_RELAXED);
+                        } else {
+                            nextResult = probeImage(image.data(), offsets.data(), maxPieces, nextBoard, ~player & 1);
+                        }
+
+                        if(nextResult == loss) {
+                            result = win;
+                        } else if(nextResult != win) {
+                            allWins = false;
+                        }
+                    }
+
+                    if(result == unknown && allWins) {
+                        result = loss;
+                    }
+
+                    if(result != unknown) {
+                        __atomic_store_n(&results[index], result, __ATOMIC_RELAXED);
+                        numChanged++;
+                    }
+                }
+
+                changed += numChanged;
+            });
+        } while(changed);
+
+        // pack the class into the image
+        offsets[((current.counts[0] * (maxPieces + 1) + current.counts[1]) * (maxPieces + 1) + current.counts[2])
+                * (maxPieces + 1) + current.counts[3]] = image.size();
+        image.resize(image.size() + (results.size() + 3) / 4, 0);
+        std::fill(counts, counts + 4, 0);
+
+        for(i = 0; i < results.size(); i++) {
+            counts[results[i]]++;
+            image[image.size() - (results.size() + 3) / 4 + (i >> 2)] |= results[i] << (2 * (i & 3));
+        }
+
+        seconds = std::chrono::duration<double>(Checkers::Clock::now() - ti).count();
+        std::cout << std::setw(10) << current.counts[0] << " " << current.counts[1] << " v " << current.counts[2] << " " << current.counts[3]
+                  << std::setw(12) << results.size() - counts[invalid] << std::setw(12) << counts[win]
+                  << std::setw(12) << counts[loss] << std::setw(12) << counts[unknown] << std::setw(8) << passes
+                  << std::setw(10) << std::fixed << std::setprecision(2) << seconds << std::endl;
+    }
+
+    std::copy((uint8_t const *) &header, (uint8_t const *) (&header + 1), image.begin());
+    std::copy((uint8_t const *) offsets.data(), (uint8_t const *) (offsets.data() + offsets.size()), image.begin() + sizeof(header));
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if(!file.write((char const *) image.data(), image.size())) {
+        std::cout << "Could not write tablebase file '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote " << image.size() << " bytes to '" << filePath << "'" << std::endl;
+
+    return true;
+}
+
+
+bool Checkers::Tablebase::open(std::string const& filePath) {
+    TablebaseHeader header;
+    struct stat fileStat;
+    MaterialClass material;
+    uint64_t directorySize, i;
+    int counts[4], j;
+    void * address;
+    int fd;
+
+    this->close();
+
+    fd = ::open(filePath.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    if(fstat(fd, &fileStat) || (uint64_t) fileStat.st_size < sizeof(header)) {
+        ::close(fd);
+        return false;
+    }
+
+    address = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED) {
+        return false;
+    }
+
+    size_t size = fileStat.st_size;
+    std::shared_ptr<const uint8_t> mapping((uint8_t const *) address, [size](uint8_t const * address) {
+        munmap((void *) address, size);
+    });
+
+    // check the header, and that every class lies within the file
+    header = *(TablebaseHeader const *) address;
+    if(header.magic != tablebaseMagic || header.maxPieces < 2 || (int) header.maxPieces > tablebaseMaxPieces) {
+        return false;
+    }
+
+    directorySize = (header.maxPieces + 1) * (header.maxPieces + 1) * (header.maxPieces + 1) * (header.maxPieces + 1);
+    if(size < sizeof(header) + directorySize * sizeof(uint64_t)) {
+        return false;
+    }
+
+    uint64_t const * offsets = (uint64_t const *) (mapping.get() + sizeof(header));
+    for(i = 0; i < directorySize; i++) {
+        if(!offsets[i]) {
+            continue;
+        }
+
+        for(j = 3, counts[3] = i; j > 0; j--) {
+            counts[j - 1] = counts[j] / (header.maxPieces + 1);
+            counts[j] %= header.maxPieces + 1;
+        }
+        setMaterialClass(material, counts[0], counts[1], counts[2], counts[3]);
+
+        if(offsets[i] + (2 * material.size + 3) / 4 > size) {
+            return false;
+        }
+    }
+
+    this->mapping = mapping;
+    this->offsets = offsets;
+    this->maxPieces = header.maxPieces;
+
+    return true;
+}
+
+
+void Checkers::Tablebase::close() {
+    this->mapping.reset();
+    this->offsets = nullptr;
+    this->maxPieces = 0;
+}
+
+
+int Checkers::Tablebase::getMaxPieces() {
+    return this->maxPieces;
+}
+
+
+Checkers::TablebaseResult Checkers::Tablebase::probe(Board const& board, unsigned short player) {
+    if(!this->mapping) {
+        return Checkers::tablebaseUnknown;
+    }
+
+    return probeImage(this->mapping.get(), this->offsets, this->maxPieces, board, player);
+}
+///////////////////////////////////////
+// END  Tablebase method definitions //
+///////////////////////////////////////